@@ -11,6 +11,11 @@ int get_client_socket_fd(void);
 
 void close_client_socket_fd(void);
 
+// Opens a UDP socket aimed at the same server for low-latency input
+bool init_udp_channel(const char *server_ip, int port);
+
+int get_udp_socket_fd(void);
+
 // Closes the joystick client connection
 void cleanup_client(void);
 
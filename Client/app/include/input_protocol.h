@@ -0,0 +1,48 @@
+#ifndef _INPUT_PROTOCOL_H_
+#define _INPUT_PROTOCOL_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "joystick.h"
+
+/**
+ * Encoder for the binary input protocol sent to the server.
+ *
+ * Frame: u8 magic (0xA5), u8 version, u8 type, u8 payload length, payload.
+ * Multi-byte fields are big-endian.
+ *   INPUT (6 bytes): u16 seq, u8 direction, i16 rotation, u8 flags (bit 0 = fire)
+ *   CHEAT (2 bytes): u16 seq
+ *   SUBSCRIBE (2 bytes): u16 seq
+ *   INPUT_BUNDLE (UDP): u32 token, u8 n, then n INPUT payloads, newest first
+ * Must match Server/include/InputProtocol.h.
+ */
+
+#define INPUT_PROTOCOL_MAGIC 0xA5
+#define INPUT_PROTOCOL_VERSION 1
+#define INPUT_PROTOCOL_MAX_FRAME 10
+#define INPUT_PROTOCOL_MAX_BUNDLE 8
+
+typedef struct {
+    uint16_t seq;
+    JoystickDirection direction;
+    int rotation;
+    bool fire;
+} InputFrame;
+
+// Fill buf with an INPUT frame; returns its length, or 0 if buf is too small
+size_t InputProtocol_encodeInput(uint8_t *buf, size_t size, uint16_t seq,
+                                 JoystickDirection direction, int rotation, bool fire);
+
+// Fill buf with a CHEAT frame; returns its length, or 0 if buf is too small
+size_t InputProtocol_encodeCheat(uint8_t *buf, size_t size, uint16_t seq);
+
+// Fill buf with a SUBSCRIBE frame (start the state stream); returns its length
+size_t InputProtocol_encodeSubscribe(uint8_t *buf, size_t size, uint16_t seq);
+
+// Fill buf with an INPUT_BUNDLE datagram of frames (newest first); returns its
+// length, or 0 if buf is too small
+size_t InputProtocol_encodeBundle(uint8_t *buf, size_t size, uint32_t token,
+                                  const InputFrame *frames, int count);
+
+#endif // _INPUT_PROTOCOL_H_
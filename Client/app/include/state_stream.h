@@ -0,0 +1,59 @@
+#ifndef _STATE_STREAM_H_
+#define _STATE_STREAM_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Decoder for the server's state stream (keyframes + per-tick deltas).
+ * Keeps a local copy of the world, e.g. for drawing a minimap.
+ * Frame format is documented in Server/include/StateStream.h.
+ */
+
+#define STATE_STREAM_MAGIC 0xA6
+#define STATE_STREAM_HEADER_SIZE 7
+#define STATE_STREAM_MAX_ENEMIES 64
+#define STATE_STREAM_MAX_PROJECTILES 256
+
+typedef struct {
+    uint16_t id;
+    float x, y;
+    uint8_t direction;
+    bool spawning;
+    bool active;
+} StreamEnemy;
+
+typedef struct {
+    uint16_t id;
+    float x, y;     // at the time it was announced
+    float vx, vy;   // pixels per second
+    bool isEnemy;
+    double announcedAt;
+} StreamProjectile;
+
+typedef struct {
+    bool valid;     // false until the first keyframe, or after a bad frame
+    uint32_t tick;
+    float tankX, tankY;
+    float turretAngle;
+    uint8_t tankDirection;
+    int health;
+    bool alive;
+    int wave;
+    int enemyCount;
+    StreamEnemy enemies[STATE_STREAM_MAX_ENEMIES];
+    int projectileCount;
+    StreamProjectile projectiles[STATE_STREAM_MAX_PROJECTILES];
+} StreamWorld;
+
+// Total frame length (header included) if buf holds a complete header, else 0
+size_t StateStream_frameLength(const uint8_t *buf, size_t len);
+
+// Apply one whole frame; returns false (and waits for a keyframe) if malformed
+bool StateStream_apply(const uint8_t *frame, size_t len);
+
+// Copy of the world with projectile positions extrapolated to now
+void StateStream_getWorld(StreamWorld *out);
+
+#endif // _STATE_STREAM_H_
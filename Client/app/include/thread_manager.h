@@ -8,6 +8,15 @@ extern "C" {
 
 bool init_thread_manager(const char *server_ip, int port);
 
+// Send input as comma-separated text instead of binary frames (call before init)
+void set_text_protocol(bool enabled);
+
+// Send input over UDP with redundancy once the server hands out a token (call before init)
+void set_udp_input(bool enabled);
+
+// Ask the server for the tank/enemy/projectile state stream (call before init)
+void set_state_stream(bool enabled);
+
 void cleanup_thread_manager(void);
 
 #ifdef __cplusplus
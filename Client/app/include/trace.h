@@ -0,0 +1,47 @@
+#ifndef _TRACE_H_
+#define _TRACE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * Scoped profiling zones written as Chrome trace-event JSON, one timeline
+ * per thread. The client traces as pid 2 with wall-clock microsecond
+ * timestamps, so its file can be merged with the server's (pid 1); see
+ * Server/include/Trace.h.
+ *
+ * Compiled in only with -DTANK_TRACE=ON; otherwise TRACE_ZONE expands to
+ * nothing and the functions below do nothing.
+ */
+
+// Label the calling thread's timeline
+void Trace_setThreadName(const char *name);
+
+// Where Trace_write() puts the trace; false if it cannot be created
+bool Trace_open(const char *path);
+// Write everything recorded so far; safe while other threads are recording
+void Trace_write(void);
+
+#ifdef TANK_TRACE
+
+typedef struct {
+    const char *name;
+    uint64_t start_us;
+} TraceZone;
+
+TraceZone Trace_begin(const char *name);
+void Trace_end(TraceZone *zone);
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+// Zone from here to the end of the enclosing block; name must be a literal
+#define TRACE_ZONE(name) \
+    TraceZone TRACE_CONCAT(trace_zone_, __LINE__) __attribute__((cleanup(Trace_end))) = Trace_begin(name)
+
+#else
+
+#define TRACE_ZONE(name) ((void) 0)
+
+#endif
+
+#endif // _TRACE_H_
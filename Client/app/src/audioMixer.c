@@ -1,4 +1,5 @@
 #include "audioMixer.h"
+#include "trace.h"
 #include <alsa/asoundlib.h>
 #include <stdbool.h>
 #include <pthread.h>
@@ -203,6 +204,7 @@ void AudioMixer_setVolume(int newVolume) {
 // Playback loop
 static void *playbackThread(void *_arg) {
     (void) _arg;
+    Trace_setThreadName("audio");
     struct timespec startTime, endTime;
 
     while (!stopping) {
@@ -238,6 +240,7 @@ static void *playbackThread(void *_arg) {
 }
 
 static void fillPlaybackBuffer(short *buff, int size) {
+    TRACE_ZONE("fillPlaybackBuffer");
     memset(buff, 0, size * SAMPLE_SIZE); // zero out
 
     pthread_mutex_lock(&audioMutex);
@@ -7,6 +7,7 @@
 #include <sys/socket.h>
 
 static int sock_fd = -1;
+static int udp_fd = -1;
 
 // **Initialize the Joystick Client and Connect to Server**
 bool init_client(const char* server_ip, int port) {
@@ -40,6 +41,37 @@ bool init_client(const char* server_ip, int port) {
     return true;
 }
 
+// Connected UDP socket, so send() needs no address and ICMP errors surface
+bool init_udp_channel(const char *server_ip, int port) {
+    if (udp_fd != -1) {
+        return true;
+    }
+
+    udp_fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (udp_fd == -1) {
+        perror("UDP socket creation failed");
+        return false;
+    }
+
+    struct sockaddr_in server_addr;
+    memset(&server_addr, 0, sizeof(server_addr));
+    server_addr.sin_family = AF_INET;
+    server_addr.sin_port = htons(port);
+
+    if (inet_pton(AF_INET, server_ip, &server_addr.sin_addr) <= 0 ||
+        connect(udp_fd, (struct sockaddr*)&server_addr, sizeof(server_addr)) < 0) {
+        perror("UDP channel setup failed");
+        close(udp_fd);
+        udp_fd = -1;
+        return false;
+    }
+    return true;
+}
+
+int get_udp_socket_fd(void) {
+    return udp_fd;
+}
+
 int get_client_socket_fd(void) {
     return sock_fd;
 }
@@ -58,4 +90,8 @@ void cleanup_client(void) {
         close(sock_fd);
         sock_fd = -1;
     }
+    if (udp_fd != -1) {
+        close(udp_fd);
+        udp_fd = -1;
+    }
 }
@@ -3,6 +3,7 @@
 #include "../../lcd/lib/Config/DEV_Config.h"
 #include "../../lcd/lib/LCD/LCD_1in54.h"
 #include "../../lcd/lib/GUI/GUI_Paint.h"
+#include "../include/trace.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
@@ -30,6 +31,11 @@
 static UWORD *s_fb = NULL;
 static bool s_isInitialized = false;
 
+// What the panel is showing, so only changed pixels go over SPI
+static UWORD *s_shown = NULL;
+static bool s_shownValid = false;
+static int s_shownHealth = -1;      // -1 = nothing drawn yet
+
 void DrawStuff_init(void) {
     assert(!s_isInitialized);
 
@@ -48,7 +54,8 @@ void DrawStuff_init(void) {
     // Allocate frame buffer
     UDOUBLE imagesize = LCD_1IN54_HEIGHT * LCD_1IN54_WIDTH * 2;
     s_fb = (UWORD *) malloc(imagesize);
-    if (!s_fb) {
+    s_shown = (UWORD *) malloc(imagesize);
+    if (!s_fb || !s_shown) {
         perror("Failed to allocate LCD frame buffer");
         DEV_ModuleExit();
         exit(1);
@@ -64,6 +71,10 @@ void DrawStuff_cleanup(void) {
 
     free(s_fb);
     s_fb = NULL;
+    free(s_shown);
+    s_shown = NULL;
+    s_shownValid = false;
+    s_shownHealth = -1;
 
     DEV_ModuleExit();
     s_isInitialized = false;
@@ -75,10 +86,59 @@ void turnOffLCD(void) {
     assert(s_isInitialized);
 
     LCD_1IN54_Clear(WHITE);
+    s_shownValid = false;
+    s_shownHealth = -1;
     DEV_Delay_ms(1000);
     LCD_SetBacklight(0);
 }
 
+// Send the rows that differ from what the panel shows. Each run of changed
+// rows goes out as one window spanning the columns that changed in it.
+static void present(void) {
+    TRACE_ZONE("DrawStuff_present");
+
+    if (!s_shownValid) {
+        LCD_1IN54_Display(s_fb);
+        memcpy(s_shown, s_fb, LCD_1IN54_WIDTH * LCD_1IN54_HEIGHT * sizeof(UWORD));
+        s_shownValid = true;
+        return;
+    }
+
+    int runTop = -1;
+    int runLeft = LCD_1IN54_WIDTH;
+    int runRight = 0;
+    for (int y = 0; y <= LCD_1IN54_HEIGHT; y++) {
+        // Changed columns of this row as [left, right); empty past the last row
+        int left = 0;
+        int right = 0;
+        if (y < LCD_1IN54_HEIGHT) {
+            const UWORD *row = &s_fb[y * LCD_1IN54_WIDTH];
+            const UWORD *shown = &s_shown[y * LCD_1IN54_WIDTH];
+            if (memcmp(row, shown, LCD_1IN54_WIDTH * sizeof(UWORD)) != 0) {
+                right = LCD_1IN54_WIDTH;
+                while (row[left] == shown[left]) left++;
+                while (row[right - 1] == shown[right - 1]) right--;
+            }
+        }
+
+        if (left < right) {
+            if (runTop < 0) runTop = y;
+            if (left < runLeft) runLeft = left;
+            if (right > runRight) runRight = right;
+        } else if (runTop >= 0) {
+            // Run ended on the previous row; windows are [start, end)
+            LCD_1IN54_DisplayWindows(runLeft, runTop, runRight, y, s_fb);
+            for (int r = runTop; r < y; r++) {
+                memcpy(&s_shown[r * LCD_1IN54_WIDTH + runLeft], &s_fb[r * LCD_1IN54_WIDTH + runLeft],
+                       (runRight - runLeft) * sizeof(UWORD));
+            }
+            runTop = -1;
+            runLeft = LCD_1IN54_WIDTH;
+            runRight = 0;
+        }
+    }
+}
+
 
 
 //  Display the tank's health in four states.
@@ -96,6 +156,12 @@ void turnOffLCD(void) {
 void DisplayTankStatus(int health) {
     assert(s_isInitialized);
 
+    // Retained: the frame only depends on health, so an unchanged value costs nothing
+    if (s_shownValid && health == s_shownHealth) {
+        return;
+    }
+    s_shownHealth = health;
+
     Paint_NewImage(s_fb, LCD_1IN54_WIDTH, LCD_1IN54_HEIGHT, 0, WHITE, 16);
     Paint_Clear(WHITE);
 
@@ -177,5 +243,5 @@ void DisplayTankStatus(int health) {
         Paint_DrawCircle(153, 107, 3, YELLOW, DOT_PIXEL_1X1, DRAW_FILL_FULL);
     }
 
-    LCD_1IN54_Display(s_fb);
+    present();
 }
@@ -0,0 +1,85 @@
+#include "../include/input_protocol.h"
+
+#define TYPE_INPUT 1
+#define TYPE_CHEAT 2
+#define TYPE_INPUT_BUNDLE 3
+#define TYPE_SUBSCRIBE 4
+#define FLAG_FIRE 0x01
+
+static size_t write_header(uint8_t *buf, uint8_t type, uint8_t length) {
+    buf[0] = INPUT_PROTOCOL_MAGIC;
+    buf[1] = INPUT_PROTOCOL_VERSION;
+    buf[2] = type;
+    buf[3] = length;
+    return 4;
+}
+
+static void write_u16(uint8_t *buf, uint16_t value) {
+    buf[0] = (uint8_t) (value >> 8);
+    buf[1] = (uint8_t) (value & 0xFF);
+}
+
+// The 6-byte INPUT payload, shared by INPUT frames and bundles
+static void write_input(uint8_t *buf, uint16_t seq, JoystickDirection direction, int rotation, bool fire) {
+    // Rotation travels as a signed 16-bit value
+    if (rotation > INT16_MAX) rotation = INT16_MAX;
+    if (rotation < INT16_MIN) rotation = INT16_MIN;
+
+    write_u16(buf, seq);
+    buf[2] = (uint8_t) direction;
+    write_u16(buf + 3, (uint16_t) (int16_t) rotation);
+    buf[5] = fire ? FLAG_FIRE : 0;
+}
+
+size_t InputProtocol_encodeInput(uint8_t *buf, size_t size, uint16_t seq,
+                                 JoystickDirection direction, int rotation, bool fire) {
+    if (size < 10) {
+        return 0;
+    }
+
+    size_t len = write_header(buf, TYPE_INPUT, 6);
+    write_input(buf + len, seq, direction, rotation, fire);
+    return len + 6;
+}
+
+static size_t encode_seq_only(uint8_t *buf, size_t size, uint8_t type, uint16_t seq) {
+    if (size < 6) {
+        return 0;
+    }
+
+    size_t len = write_header(buf, type, 2);
+    write_u16(buf + len, seq);
+    return len + 2;
+}
+
+size_t InputProtocol_encodeCheat(uint8_t *buf, size_t size, uint16_t seq) {
+    return encode_seq_only(buf, size, TYPE_CHEAT, seq);
+}
+
+size_t InputProtocol_encodeSubscribe(uint8_t *buf, size_t size, uint16_t seq) {
+    return encode_seq_only(buf, size, TYPE_SUBSCRIBE, seq);
+}
+
+size_t InputProtocol_encodeBundle(uint8_t *buf, size_t size, uint32_t token,
+                                  const InputFrame *frames, int count) {
+    if (count > INPUT_PROTOCOL_MAX_BUNDLE) {
+        count = INPUT_PROTOCOL_MAX_BUNDLE;
+    }
+
+    size_t payload = 5 + 6 * (size_t) count;
+    if (size < 4 + payload) {
+        return 0;
+    }
+
+    size_t len = write_header(buf, TYPE_INPUT_BUNDLE, (uint8_t) payload);
+    write_u16(buf + len, (uint16_t) (token >> 16));
+    write_u16(buf + len + 2, (uint16_t) (token & 0xFFFF));
+    buf[len + 4] = (uint8_t) count;
+    len += 5;
+
+    for (int i = 0; i < count; i++) {
+        write_input(buf + len, frames[i].seq, frames[i].direction, frames[i].rotation, frames[i].fire);
+        len += 6;
+    }
+    return len;
+}
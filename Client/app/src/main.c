@@ -1,13 +1,58 @@
 #include "../include/thread_manager.h"
+#include "../include/trace.h"
+#include "joystick.h"
 #include "shutdown.h"
+#include <signal.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 
 #define SERVER_IP "192.168.6.1"
 #define SERVER_PORT 8080
 
-int main(void) {
+static void signal_handler(int signo) {
+    (void) signo;
+    request_shutdown();
+}
+
+int main(int argc, char *argv[]) {
+    // --text-protocol falls back to the comma-separated input format;
+    // --udp sends input over the low-latency UDP channel;
+    // --state-stream subscribes to the server's world state;
+    // --trace=FILE writes profiling zones on exit (TANK_TRACE builds);
+    // --stick-filter=N smooths the stick over ~2^N samples (0 = off);
+    // --stick-dead-zone=N ignores deflection up to N of 100
+    JoystickConfig stick = {JOYSTICK_DEFAULT_FILTER_SHIFT, JOYSTICK_DEFAULT_DEAD_ZONE,
+                            JOYSTICK_DEFAULT_DIRECTION_THRESHOLD};
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--text-protocol") == 0) {
+            set_text_protocol(true);
+        } else if (strcmp(argv[i], "--udp") == 0) {
+            set_udp_input(true);
+        } else if (strcmp(argv[i], "--state-stream") == 0) {
+            set_state_stream(true);
+        } else if (strncmp(argv[i], "--stick-filter=", 15) == 0) {
+            stick.filter_shift = atoi(argv[i] + 15);
+        } else if (strncmp(argv[i], "--stick-dead-zone=", 18) == 0) {
+            stick.dead_zone = atoi(argv[i] + 18);
+        } else if (strncmp(argv[i], "--trace=", 8) == 0 && !Trace_open(argv[i] + 8)) {
+            fprintf(stderr, "Not tracing: cannot write %s or built without -DTANK_TRACE=ON\n", argv[i] + 8);
+        }
+    }
+    Trace_setThreadName("main");
+    configure_joystick(&stick);
+
+    // Ctrl-C ends the main loop so the trace still gets written; a second
+    // one kills the process if cleanup hangs on a blocked thread
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = signal_handler;
+    action.sa_flags = SA_RESETHAND;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+
     if (!init_thread_manager(SERVER_IP, SERVER_PORT)) {
         fprintf(stderr, "Failed to initialize thread manager\n");
         return EXIT_FAILURE;
@@ -17,7 +62,10 @@ int main(void) {
         sleep(1);
     }
 
-    // This will never be reached in current design
+    // Before cleanup, which can block on threads that never return
+    Trace_write();
+
+    // Threads poll the same flag and exit on their own
     cleanup_thread_manager();
     return 0;
 }
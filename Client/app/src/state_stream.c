@@ -0,0 +1,202 @@
+#include "../include/state_stream.h"
+#include <pthread.h>
+#include <string.h>
+#include <time.h>
+
+#define TYPE_KEYFRAME 1
+#define TYPE_DELTA 2
+
+#define TANK_POS 0x01
+#define TANK_TURRET 0x02
+#define TANK_DIR 0x04
+#define TANK_HEALTH 0x08
+#define WAVE 0x10
+
+#define ENEMY_SPAWNING 1
+#define ENEMY_ACTIVE 2
+
+static StreamWorld s_world;
+static pthread_mutex_t s_world_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+// Bounds-checked cursor over one frame's payload
+typedef struct {
+    const uint8_t *data;
+    size_t len;
+    size_t pos;
+    bool ok;
+} Reader;
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static uint8_t read_u8(Reader *r) {
+    if (r->pos + 1 > r->len) {
+        r->ok = false;
+        return 0;
+    }
+    return r->data[r->pos++];
+}
+
+static uint16_t read_u16(Reader *r) {
+    uint16_t hi = read_u8(r);
+    return (uint16_t) ((hi << 8) | read_u8(r));
+}
+
+static uint32_t read_u32(Reader *r) {
+    uint32_t hi = read_u16(r);
+    return (hi << 16) | read_u16(r);
+}
+
+static float read_pos(Reader *r) {
+    return read_u16(r) / 16.0f;
+}
+
+size_t StateStream_frameLength(const uint8_t *buf, size_t len) {
+    if (len < STATE_STREAM_HEADER_SIZE) {
+        return 0;
+    }
+    uint32_t payload = ((uint32_t) buf[3] << 24) | ((uint32_t) buf[4] << 16) |
+                       ((uint32_t) buf[5] << 8) | buf[6];
+    return STATE_STREAM_HEADER_SIZE + payload;
+}
+
+static void remove_enemy(uint16_t id) {
+    for (int i = 0; i < s_world.enemyCount; i++) {
+        if (s_world.enemies[i].id == id) {
+            s_world.enemies[i] = s_world.enemies[--s_world.enemyCount];
+            return;
+        }
+    }
+}
+
+static void upsert_enemy(const StreamEnemy *enemy) {
+    for (int i = 0; i < s_world.enemyCount; i++) {
+        if (s_world.enemies[i].id == enemy->id) {
+            s_world.enemies[i] = *enemy;
+            return;
+        }
+    }
+    if (s_world.enemyCount < STATE_STREAM_MAX_ENEMIES) {
+        s_world.enemies[s_world.enemyCount++] = *enemy;
+    }
+}
+
+static void remove_projectile(uint16_t id) {
+    for (int i = 0; i < s_world.projectileCount; i++) {
+        if (s_world.projectiles[i].id == id) {
+            s_world.projectiles[i] = s_world.projectiles[--s_world.projectileCount];
+            return;
+        }
+    }
+}
+
+// Called with s_world_mutex held
+static bool apply_payload(Reader *r, bool keyframe) {
+    double now = now_seconds();
+
+    if (keyframe) {
+        s_world.enemyCount = 0;
+        s_world.projectileCount = 0;
+    }
+
+    s_world.tick = read_u32(r);
+    uint8_t mask = read_u8(r);
+    if (mask & TANK_POS) {
+        s_world.tankX = read_pos(r);
+        s_world.tankY = read_pos(r);
+    }
+    if (mask & TANK_TURRET) {
+        s_world.turretAngle = read_u16(r) / 100.0f;
+    }
+    if (mask & TANK_DIR) {
+        s_world.tankDirection = read_u8(r);
+    }
+    if (mask & TANK_HEALTH) {
+        s_world.health = (int8_t) read_u8(r);
+        s_world.alive = read_u8(r) != 0;
+    }
+    if (mask & WAVE) {
+        s_world.wave = read_u16(r);
+    }
+
+    int removed = read_u16(r);
+    for (int i = 0; i < removed && r->ok; i++) {
+        remove_enemy(read_u16(r));
+    }
+    int upserted = read_u16(r);
+    for (int i = 0; i < upserted && r->ok; i++) {
+        StreamEnemy enemy;
+        enemy.id = read_u16(r);
+        enemy.x = read_pos(r);
+        enemy.y = read_pos(r);
+        uint8_t packed = read_u8(r);
+        enemy.direction = packed & 0x0F;
+        enemy.spawning = ((packed >> 4) & ENEMY_SPAWNING) != 0;
+        enemy.active = ((packed >> 4) & ENEMY_ACTIVE) != 0;
+        upsert_enemy(&enemy);
+    }
+
+    removed = read_u16(r);
+    for (int i = 0; i < removed && r->ok; i++) {
+        remove_projectile(read_u16(r));
+    }
+    int added = read_u16(r);
+    for (int i = 0; i < added && r->ok; i++) {
+        StreamProjectile p;
+        p.id = read_u16(r);
+        p.x = read_pos(r);
+        p.y = read_pos(r);
+        p.vx = (int16_t) read_u16(r);
+        p.vy = (int16_t) read_u16(r);
+        p.isEnemy = read_u8(r) != 0;
+        p.announcedAt = now;
+        if (s_world.projectileCount < STATE_STREAM_MAX_PROJECTILES) {
+            s_world.projectiles[s_world.projectileCount++] = p;
+        }
+    }
+
+    return r->ok;
+}
+
+bool StateStream_apply(const uint8_t *frame, size_t len) {
+    size_t total = StateStream_frameLength(frame, len);
+    if (total == 0 || total > len || frame[0] != STATE_STREAM_MAGIC) {
+        return false;
+    }
+
+    uint8_t type = frame[2];
+    bool keyframe = type == TYPE_KEYFRAME;
+    if (!keyframe && type != TYPE_DELTA) {
+        // Unknown type from a newer server; skip it
+        return true;
+    }
+
+    Reader r = {frame + STATE_STREAM_HEADER_SIZE, total - STATE_STREAM_HEADER_SIZE, 0, true};
+
+    pthread_mutex_lock(&s_world_mutex);
+    bool ok = false;
+    if (keyframe || s_world.valid) {
+        ok = apply_payload(&r, keyframe);
+        s_world.valid = ok;
+    }
+    pthread_mutex_unlock(&s_world_mutex);
+    return ok;
+}
+
+void StateStream_getWorld(StreamWorld *out) {
+    pthread_mutex_lock(&s_world_mutex);
+    memcpy(out, &s_world, sizeof(*out));
+    pthread_mutex_unlock(&s_world_mutex);
+
+    double now = now_seconds();
+    for (int i = 0; i < out->projectileCount; i++) {
+        StreamProjectile *p = &out->projectiles[i];
+        float age = (float) (now - p->announcedAt);
+        p->x += p->vx * age;
+        p->y += p->vy * age;
+        p->announcedAt = now;
+    }
+}
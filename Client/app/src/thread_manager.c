@@ -1,7 +1,11 @@
 #include "../include/thread_manager.h"
 #include "../include/joystick.h"
+#include "../include/i2c_bus.h"
 #include "../include/rotary_encoder.h"
 #include "../include/client.h"
+#include "../include/input_protocol.h"
+#include "../include/state_stream.h"
+#include "../include/trace.h"
 #include "gpio.h"
 #include "draw_stuff.h"
 #include "sound_effects.h"
@@ -10,13 +14,13 @@
 #include <pthread.h>
 #include <unistd.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <sys/socket.h>
 #include <string.h>
 
 #include "../include/accelerometer.h"
 #include <time.h>
 
-static pthread_t s_joystick_thread;
 static pthread_t s_rotary_thread;
 static pthread_t s_transmit_thread;
 static pthread_t s_receive_thread;
@@ -24,6 +28,7 @@ static pthread_t s_lcd_thread;
 
 static pthread_t s_accelerometer_thread;
 static atomic_bool s_newCheatRequest = false;
+static bool s_accelerometer_ok = false;
 
 // Flags
 static atomic_bool s_running = false;
@@ -33,7 +38,6 @@ static atomic_int s_client_connected = false;
 static char s_server_ip[16];
 static int s_server_port;
 
-static JoystickDirection s_current_direction = NO_DIRECTION;
 static volatile int s_rotation_delta = 0;
 static volatile bool s_button_pressed = false;
 static pthread_mutex_t s_data_mutex = PTHREAD_MUTEX_INITIALIZER;
@@ -41,41 +45,143 @@ static pthread_mutex_t s_data_mutex = PTHREAD_MUTEX_INITIALIZER;
 // store tank health from the server.
 static atomic_int s_tank_health = 3;
 
-static void send_initial_state(int sock_fd) {
-    char buffer[32] = "NONE";
+// Binary framing by default; the comma-separated text format is a fallback
+static atomic_bool s_text_protocol = false;
+static uint16_t s_input_seq = 0;
 
-    pthread_mutex_lock(&s_data_mutex);
-    if (s_rotation_delta != 0) {
+// Encode one input state in the selected protocol; returns its length
+static size_t format_input(uint8_t *buffer, size_t size, JoystickDirection dir, int rotation_delta, bool button_pressed) {
+    if (!s_text_protocol) {
+        return InputProtocol_encodeInput(buffer, size, ++s_input_seq, dir, rotation_delta, button_pressed);
+    }
+
+    char *text = (char *) buffer;
+    switch (dir) {
+        case UP:
+            strcpy(text, "UP");
+            break;
+        case DOWN:
+            strcpy(text, "DOWN");
+            break;
+        case LEFT:
+            strcpy(text, "LEFT");
+            break;
+        case RIGHT:
+            strcpy(text, "RIGHT");
+            break;
+        default:
+            strcpy(text, "NONE");
+            break;
+    }
+
+    // Add rotation data if any
+    if (rotation_delta != 0) {
         char rot_buf[16];
-        snprintf(rot_buf, sizeof(rot_buf), ",ROT:%d", s_rotation_delta);
-        strcat(buffer, rot_buf);
+        snprintf(rot_buf, sizeof(rot_buf), ",ROT:%d", rotation_delta);
+        strcat(text, rot_buf);
     }
-    if (s_button_pressed) {
-        strcat(buffer, ",BTN:1");
+
+    // Add button data if pressed
+    if (button_pressed) {
+        strcat(text, ",BTN:1");
     }
-    pthread_mutex_unlock(&s_data_mutex);
 
-    send(sock_fd, buffer, strlen(buffer), MSG_NOSIGNAL);
+    // The server frames text messages by newline
+    strcat(text, "\n");
+    return strlen(text);
 }
 
-static void *joystick_thread_func(void *arg) {
-    (void) arg;
-    while (s_running && !is_shutdown_requested()) {
-        JoystickOutput joystick = read_joystick();
+static size_t format_cheat(uint8_t *buffer, size_t size) {
+    if (!s_text_protocol) {
+        return InputProtocol_encodeCheat(buffer, size, ++s_input_seq);
+    }
+    memcpy(buffer, "CHEAT\n", 6);
+    return 6;
+}
+
+void set_text_protocol(bool enabled) {
+    s_text_protocol = enabled;
+}
+
+// Subscribe to the server's state stream (decoded by state_stream.c)
+static atomic_bool s_state_stream = false;
+
+void set_state_stream(bool enabled) {
+    s_state_stream = enabled;
+}
+
+// Optional UDP input: each datagram repeats the last few inputs so one lost
+// packet costs nothing, and there is no head-of-line blocking behind it.
+#define UDP_REDUNDANCY 4
+#define UDP_SEND_INTERVAL_US 5000
+
+static atomic_bool s_udp_input = false;
+static atomic_uint s_udp_token = 0;   // from the server's "UDP:" line; 0 = none yet
+static InputFrame s_udp_history[UDP_REDUNDANCY];
+static int s_udp_history_count = 0;
+static uint32_t s_udp_history_token = 0;
+
+void set_udp_input(bool enabled) {
+    s_udp_input = enabled;
+}
 
-        pthread_mutex_lock(&s_data_mutex);
-        s_current_direction = joystick.direction;
-        pthread_mutex_unlock(&s_data_mutex);
+static bool udp_ready(void) {
+    return s_udp_input && !s_text_protocol && s_udp_token != 0 && get_udp_socket_fd() >= 0;
+}
 
-        usleep(20000); // 50Hz update rate
+// Record the newest input and send the recent history as one datagram
+static void send_udp_input(JoystickDirection dir, int rotation_delta, bool button_pressed) {
+    uint32_t token = s_udp_token;
+    if (token != s_udp_history_token) {
+        // New session; the server has never seen these frames
+        s_udp_history_count = 0;
+        s_udp_history_token = token;
+    }
+
+    memmove(&s_udp_history[1], &s_udp_history[0], sizeof(s_udp_history[0]) * (UDP_REDUNDANCY - 1));
+    s_udp_history[0].seq = ++s_input_seq;
+    s_udp_history[0].direction = dir;
+    s_udp_history[0].rotation = rotation_delta;
+    s_udp_history[0].fire = button_pressed;
+    if (s_udp_history_count < UDP_REDUNDANCY) {
+        s_udp_history_count++;
+    }
+
+    uint8_t datagram[64];
+    size_t length = InputProtocol_encodeBundle(datagram, sizeof(datagram), token,
+                                               s_udp_history, s_udp_history_count);
+    // Best effort: the next datagram carries this input again
+    send(get_udp_socket_fd(), datagram, length, MSG_NOSIGNAL | MSG_DONTWAIT);
+}
+
+static void send_initial_state(int sock_fd) {
+    uint8_t buffer[32];
+
+    pthread_mutex_lock(&s_data_mutex);
+    size_t len = format_input(buffer, sizeof(buffer), NO_DIRECTION, s_rotation_delta, s_button_pressed);
+    pthread_mutex_unlock(&s_data_mutex);
+
+    send(sock_fd, buffer, len, MSG_NOSIGNAL);
+
+    if (s_state_stream) {
+        if (s_text_protocol) {
+            len = 6;
+            memcpy(buffer, "STATE\n", len);
+        } else {
+            len = InputProtocol_encodeSubscribe(buffer, sizeof(buffer), ++s_input_seq);
+        }
+        send(sock_fd, buffer, len, MSG_NOSIGNAL);
     }
-    return NULL;
 }
 
 static void *rotary_thread_func(void *arg) {
     (void) arg;
+    Trace_setThreadName("rotary");
     while (s_running && !is_shutdown_requested()) {
-        RotaryEncoder_processEvents();
+        // Sleeps until an edge arrives; the timeout only bounds shutdown latency
+        if (!RotaryEncoder_processEvents(100)) {
+            continue;
+        }
 
         // Read current state
         int rotation = RotaryEncoder_readRotation();
@@ -92,8 +198,6 @@ static void *rotary_thread_func(void *arg) {
             }
             pthread_mutex_unlock(&s_data_mutex);
         }
-
-        usleep(1000); // 1ms sleep for very responsive handling
     }
     return NULL;
 }
@@ -107,23 +211,26 @@ typedef enum {
     TILT_RIGHT
 } TiltDirection;
 
-static TiltDirection getTiltDirectionFromAccelerometer(void) {
+static bool getTiltDirectionFromAccelerometer(TiltDirection *tilt) {
     float x_tilt, y_tilt;
-    Accelerometer_getTiltDirection(&x_tilt, &y_tilt);
+    if (!Accelerometer_getTiltDirection(&x_tilt, &y_tilt)) {
+        return false;
+    }
 
     const float TILT_THRESHOLD = 0.5f;
 
     if (x_tilt < -TILT_THRESHOLD) {
-        return TILT_DOWN;
+        *tilt = TILT_DOWN;
     } else if (x_tilt > TILT_THRESHOLD) {
-        return TILT_UP;
+        *tilt = TILT_UP;
     } else if (y_tilt > TILT_THRESHOLD) {
-        return TILT_RIGHT;
+        *tilt = TILT_RIGHT;
     } else if (y_tilt < -TILT_THRESHOLD) {
-        return TILT_LEFT;
+        *tilt = TILT_LEFT;
     } else {
-        return TILT_FLAT;
+        *tilt = TILT_FLAT;
     }
+    return true;
 }
 
 // New cheat sequence: DOWN → FLAT → LEFT → FLAT → RIGHT → FLAT
@@ -132,17 +239,34 @@ static const TiltDirection CHEAT_SEQUENCE[] = {
 };
 static const int CHEAT_SEQUENCE_LENGTH = 6;
 static const double CHEAT_TIMEOUT_SECONDS = 5.0;
+// Give up on the cheat after this many failed reads in a row
+static const int ACCEL_MAX_FAILURES = 10;
 
 
 static void *accelerometer_thread_func(void *arg) {
     (void) arg;
+    Trace_setThreadName("accelerometer");
+
+    if (!s_accelerometer_ok) {
+        return NULL;
+    }
 
     int cheatIndex = 0;
     bool inCheatSequence = false;
+    int failures = 0;
     struct timespec startTime;
 
     while (s_running && !is_shutdown_requested()) {
-        TiltDirection currentTilt = getTiltDirectionFromAccelerometer();
+        TiltDirection currentTilt;
+        if (!getTiltDirectionFromAccelerometer(&currentTilt)) {
+            if (++failures == ACCEL_MAX_FAILURES) {
+                fprintf(stderr, "[ACCEL] Accelerometer not responding. Cheat code disabled.\n");
+                return NULL;
+            }
+            usleep(200000);
+            continue;
+        }
+        failures = 0;
 
         if (!inCheatSequence) {
             if (currentTilt == CHEAT_SEQUENCE[0]) {
@@ -187,18 +311,22 @@ static void *accelerometer_thread_func(void *arg) {
 
 static void *transmit_thread_func(void *arg) {
     (void) arg;
+    Trace_setThreadName("transmit");
     while (s_running && !is_shutdown_requested()) {
+        bool via_udp = false;
         if (s_client_connected) {
+            TRACE_ZONE("transmit_thread_func");
             JoystickDirection current_dir;
             int rotation_delta;
             bool button_pressed;
-            char buffer[32];
+            uint8_t buffer[32];
+            size_t length;
             int retry_count = 0;
             bool send_success = false;
 
             // Get current state
+            current_dir = read_joystick().direction;
             pthread_mutex_lock(&s_data_mutex);
-            current_dir = s_current_direction;
             rotation_delta = s_rotation_delta;
             button_pressed = s_button_pressed;
             // Reset after reading
@@ -206,40 +334,17 @@ static void *transmit_thread_func(void *arg) {
             s_button_pressed = false;
             pthread_mutex_unlock(&s_data_mutex);
 
-            // Format data
-            switch (current_dir) {
-                case UP:
-                    strcpy(buffer, "UP");
-                    break;
-                case DOWN:
-                    strcpy(buffer, "DOWN");
-                    break;
-                case LEFT:
-                    strcpy(buffer, "LEFT");
-                    break;
-                case RIGHT:
-                    strcpy(buffer, "RIGHT");
-                    break;
-                default:
-                    strcpy(buffer, "NONE");
-                    break;
-            }
-
-            // Add rotation data if any
-            if (rotation_delta != 0) {
-                char rot_buf[16];
-                snprintf(rot_buf, sizeof(rot_buf), ",ROT:%d", rotation_delta);
-                strcat(buffer, rot_buf);
-            }
-
-            // Add button data if pressed
-            if (button_pressed) {
-                strcat(buffer, ",BTN:1");
+            via_udp = udp_ready();
+            if (via_udp) {
+                send_udp_input(current_dir, rotation_delta, button_pressed);
+                send_success = true;
+            } else {
+                length = format_input(buffer, sizeof(buffer), current_dir, rotation_delta, button_pressed);
             }
 
             // Try sending with retries
-            while (retry_count < 3 && !send_success && s_client_connected) {
-                if (send(get_client_socket_fd(), buffer, strlen(buffer), MSG_NOSIGNAL) > 0) {
+            while (!via_udp && retry_count < 3 && !send_success && s_client_connected) {
+                if (send(get_client_socket_fd(), buffer, length, MSG_NOSIGNAL) > 0) {
                     send_success = true;
                 } else {
                     perror("Failed to send input data");
@@ -252,6 +357,7 @@ static void *transmit_thread_func(void *arg) {
                 s_client_connected = false;
             }
 
+            // The cheat is a one-off event, so it always goes over TCP
             if (s_client_connected) {
                 bool localCheat = false;
                 pthread_mutex_lock(&s_data_mutex);
@@ -262,10 +368,11 @@ static void *transmit_thread_func(void *arg) {
                 pthread_mutex_unlock(&s_data_mutex);
 
                 if (localCheat) {
+                    length = format_cheat(buffer, sizeof(buffer));
                     retry_count = 0;
                     send_success = false;
                     while (retry_count < 3 && !send_success && s_client_connected) {
-                        if (send(get_client_socket_fd(), "CHEAT", 5, MSG_NOSIGNAL) > 0) {
+                        if (send(get_client_socket_fd(), buffer, length, MSG_NOSIGNAL) > 0) {
                             send_success = true;
                             printf("[ACCEL] Cheat code sent to server.\n");
                         } else {
@@ -289,18 +396,84 @@ static void *transmit_thread_func(void *arg) {
             }
         }
 
-        usleep(50000);
+        usleep(via_udp ? UDP_SEND_INTERVAL_US : 50000);
     }
 
     return NULL;
 }
 
+// Large enough for a keyframe with a few hundred projectiles
+#define RECV_BUFFER_SIZE 8192
+
+// Handle one newline-terminated text message from the server
+static void handle_server_message(const char *message) {
+    if (strncmp(message, "HP:", 3) == 0) {
+        s_tank_health = atoi(message + 3);
+    } else if (strncmp(message, "UDP:", 4) == 0) {
+        s_udp_token = (unsigned) strtoul(message + 4, NULL, 10);
+    } else if (strcmp(message, "HIT") == 0) {
+        SoundEffects_playHit();
+        flash_LED(RED, 3, 333);
+    } else if (strcmp(message, "GAME_OVER") == 0) {
+        SoundEffects_playLost();
+        printf("Received game over from server. Shutting down...\n");
+        request_shutdown();
+    }
+}
+
+// Split the receive buffer into text lines and binary state frames;
+// returns how many bytes were consumed
+static size_t parse_server_stream(uint8_t *buf, size_t len, size_t *skip) {
+    size_t pos = 0;
+    while (pos < len && !is_shutdown_requested()) {
+        // Rest of a state frame too big for the buffer
+        if (*skip > 0) {
+            size_t n = len - pos < *skip ? len - pos : *skip;
+            pos += n;
+            *skip -= n;
+            continue;
+        }
+
+        if (buf[pos] == STATE_STREAM_MAGIC) {
+            size_t frame_len = StateStream_frameLength(buf + pos, len - pos);
+            if (frame_len == 0) {
+                break;
+            }
+            if (frame_len > RECV_BUFFER_SIZE) {
+                fprintf(stderr, "State frame too large (%zu bytes); skipping\n", frame_len);
+                *skip = frame_len;
+                continue;
+            }
+            if (frame_len > len - pos) {
+                break;
+            }
+            StateStream_apply(buf + pos, frame_len);
+            pos += frame_len;
+            continue;
+        }
+
+        uint8_t *newline = memchr(buf + pos, '\n', len - pos);
+        if (newline == NULL) {
+            break;
+        }
+        *newline = '\0';
+        handle_server_message((const char *) (buf + pos));
+        pos = (size_t) (newline - buf) + 1;
+    }
+    return pos;
+}
+
 static void *receive_thread_func(void *arg) {
     (void) arg;
+    Trace_setThreadName("receive");
 
-    char recv_buf[64];
+    static uint8_t recv_buf[RECV_BUFFER_SIZE];
+    size_t fill = 0;
+    size_t skip = 0;
     while (s_running && !is_shutdown_requested()) {
         if (!s_client_connected) {
+            fill = 0;
+            skip = 0;
             usleep(100000);
             continue;
         }
@@ -311,8 +484,17 @@ static void *receive_thread_func(void *arg) {
             continue;
         }
 
-        memset(recv_buf, 0, sizeof(recv_buf));
-        int ret = recv(fd, recv_buf, sizeof(recv_buf) - 1, 0);
+        if (fill == sizeof(recv_buf)) {
+            // A text line longer than the buffer; drop it
+            fill = 0;
+        }
+
+        // Blocks until the server sends something
+        int ret;
+        {
+            TRACE_ZONE("receive_thread_func recv");
+            ret = recv(fd, recv_buf + fill, sizeof(recv_buf) - fill, 0);
+        }
         if (ret <= 0) {
             if (ret < 0) {
                 perror("Error receiving from server");
@@ -320,31 +502,15 @@ static void *receive_thread_func(void *arg) {
                 fprintf(stderr, "Server disconnected.\n");
             }
             s_client_connected = false;
+            s_udp_token = 0;
             close_client_socket_fd();
         } else {
-            // Ensure null termination
-            recv_buf[ret] = '\0';
-
-            // Split messages by newline in case multiple came in
-            char *message = strtok(recv_buf, "\n");
-            while (message != NULL) {
-                if (strncmp(message, "HP:", 3) == 0) {
-                    s_tank_health = atoi(message + 3);
-                } else if (strcmp(message, "HIT") == 0) {
-                    SoundEffects_playHit();
-                    flash_LED(RED, 3, 333);
-                } else if (strcmp(message, "GAME_OVER") == 0) {
-                    SoundEffects_playLost();
-                    printf("Received game over from server. Shutting down...\n");
-                    request_shutdown();
-                    break;
-                }
-
-                message = strtok(NULL, "\n");
-            }
+            TRACE_ZONE("receive_thread_func");
+            fill += ret;
+            size_t used = parse_server_stream(recv_buf, fill, &skip);
+            memmove(recv_buf, recv_buf + used, fill - used);
+            fill -= used;
         }
-
-        usleep(50000);
     }
 
     return NULL;
@@ -354,6 +520,7 @@ static void *receive_thread_func(void *arg) {
 // Periodically display the tank's current health on the LCD.
 static void *lcd_thread_func(void *arg) {
     (void) arg;
+    Trace_setThreadName("lcd");
     while (s_running && !is_shutdown_requested()) {
         int localHealth = s_tank_health;
         DisplayTankStatus(localHealth);
@@ -372,16 +539,35 @@ bool init_thread_manager(const char *server_ip, int port) {
     s_server_ip[sizeof(s_server_ip) - 1] = '\0';
     s_server_port = port;
 
+    // The joystick and accelerometer share this bus and its polling thread
+    if (!I2cBus_open(I2C_BUS_PATH)) {
+        return false;
+    }
+
     // Initialize HAL modules
     DrawStuff_init();
     Gpio_initialize();
-    init_joystick();
+    if (init_joystick()) {
+        I2cBus_addDevice("joystick", JOYSTICK_SAMPLE_PERIOD_US, sample_joystick);
+    } else {
+        fprintf(stderr, "Warning: Joystick ADC not responding. Joystick will be unavailable.\n");
+    }
     RotaryEncoder_init();
     SoundEffects_init();
     init_LEDs();
 
-    if (!Accelerometer_init()) {
+    s_accelerometer_ok = Accelerometer_init();
+    if (!s_accelerometer_ok) {
         fprintf(stderr, "Warning: Accelerometer init failed. Cheat code will be unavailable.\n");
+    } else {
+        if (!Accelerometer_enableFifo(true)) {
+            fprintf(stderr, "Warning: Accelerometer FIFO unavailable, sampling once per poll.\n");
+        }
+        I2cBus_addDevice("accelerometer", ACCELEROMETER_POLL_PERIOD_US, Accelerometer_poll);
+    }
+
+    if (s_udp_input && !init_udp_channel(s_server_ip, s_server_port)) {
+        fprintf(stderr, "Warning: UDP input unavailable, sending input over TCP.\n");
     }
 
     s_client_connected = init_client(s_server_ip, s_server_port);
@@ -392,16 +578,15 @@ bool init_thread_manager(const char *server_ip, int port) {
     // Start threads
     s_running = true;
 
-    // Start joystick thread
-    if (pthread_create(&s_joystick_thread, NULL, joystick_thread_func, NULL) != 0) {
-        perror("Failed to create joystick thread");
+    // Start sampling the I2C devices
+    if (!I2cBus_start()) {
         goto error_cleanup;
     }
 
     // Start rotary encoder thread
     if (pthread_create(&s_rotary_thread, NULL, rotary_thread_func, NULL) != 0) {
         perror("Failed to create rotary thread");
-        goto error_cleanup_joystick;
+        goto error_cleanup_bus;
     }
 
     // Start transmit thread
@@ -445,9 +630,8 @@ bool init_thread_manager(const char *server_ip, int port) {
     pthread_cancel(s_rotary_thread);
     pthread_join(s_rotary_thread, NULL);
 
-    error_cleanup_joystick:
-    pthread_cancel(s_joystick_thread);
-    pthread_join(s_joystick_thread, NULL);
+    error_cleanup_bus:
+    I2cBus_stop();
 
     error_cleanup:
     s_running = false;
@@ -457,6 +641,7 @@ bool init_thread_manager(const char *server_ip, int port) {
     cleanup_LEDs();
     Gpio_cleanup();
     DrawStuff_cleanup();
+    I2cBus_close();
     return false;
 }
 
@@ -464,7 +649,7 @@ void cleanup_thread_manager(void) {
     s_running = false;
 
     // Wait for threads to finish
-    pthread_join(s_joystick_thread, NULL);
+    I2cBus_stop();
     pthread_join(s_rotary_thread, NULL);
     pthread_join(s_transmit_thread, NULL);
     pthread_join(s_receive_thread, NULL);
@@ -481,4 +666,5 @@ void cleanup_thread_manager(void) {
     cleanup_client();
     cleanup_LEDs();
     Accelerometer_cleanup();
+    I2cBus_close();
 }
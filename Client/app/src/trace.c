@@ -0,0 +1,191 @@
+#include "../include/trace.h"
+#include <stdio.h>
+
+#ifdef TANK_TRACE
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define PROCESS_ID 2            // the server traces as pid 1
+#define MAX_THREADS 16
+#define BUFFER_EVENTS (1u << 15)    // power of two; per thread
+
+// Fields are atomics so Trace_write() may read a slot while its owner
+// overwrites it; such slots are detected and skipped rather than torn.
+typedef struct {
+    _Atomic(const char *) name;
+    atomic_ullong start_us;
+    atomic_ullong duration_us;
+} TraceEvent;
+
+typedef struct {
+    const char *name;
+    uint64_t start_us;
+    uint64_t duration_us;
+} TraceEventCopy;
+
+// One per thread, used as a ring: the newest BUFFER_EVENTS zones are kept.
+// Only the owner writes. begun is bumped before a slot is overwritten and
+// count after it is complete (release), so Trace_write() on another thread
+// can tell which slots it read intact.
+typedef struct {
+    int tid;
+    const char *thread_name;
+    atomic_ullong begun;
+    atomic_ullong count;
+    TraceEvent *events;
+} TraceBuffer;
+
+static TraceBuffer s_buffers[MAX_THREADS];
+static int s_buffer_count = 0;
+static pthread_mutex_t s_registry_mutex = PTHREAD_MUTEX_INITIALIZER;
+static char s_path[256];
+
+static __thread TraceBuffer *t_buffer = NULL;
+
+static uint64_t now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (uint64_t) ts.tv_sec * 1000000u + (uint64_t) ts.tv_nsec / 1000u;
+}
+
+// NULL if there are more threads than buffers or no memory
+static TraceBuffer *thread_buffer(void) {
+    if (t_buffer != NULL) {
+        return t_buffer;
+    }
+
+    pthread_mutex_lock(&s_registry_mutex);
+    if (s_buffer_count < MAX_THREADS) {
+        TraceEvent *events = calloc(BUFFER_EVENTS, sizeof(TraceEvent));
+        if (events != NULL) {
+            TraceBuffer *buffer = &s_buffers[s_buffer_count++];
+            buffer->tid = s_buffer_count;
+            buffer->events = events;
+            t_buffer = buffer;
+        }
+    }
+    pthread_mutex_unlock(&s_registry_mutex);
+    return t_buffer;
+}
+
+TraceZone Trace_begin(const char *name) {
+    TraceZone zone = {name, now_us()};
+    return zone;
+}
+
+void Trace_end(TraceZone *zone) {
+    TraceBuffer *buffer = thread_buffer();
+    if (buffer == NULL) {
+        return;
+    }
+
+    uint64_t n = atomic_load_explicit(&buffer->count, memory_order_relaxed);
+    atomic_store_explicit(&buffer->begun, n + 1, memory_order_relaxed);
+
+    // Release keeps the begun bump ahead of every field a reader can see
+    TraceEvent *event = &buffer->events[n & (BUFFER_EVENTS - 1)];
+    atomic_store_explicit(&event->name, zone->name, memory_order_release);
+    atomic_store_explicit(&event->start_us, zone->start_us, memory_order_release);
+    atomic_store_explicit(&event->duration_us, now_us() - zone->start_us, memory_order_release);
+    atomic_store_explicit(&buffer->count, n + 1, memory_order_release);
+}
+
+void Trace_setThreadName(const char *name) {
+    TraceBuffer *buffer = thread_buffer();
+    if (buffer == NULL) {
+        return;
+    }
+    pthread_mutex_lock(&s_registry_mutex);
+    buffer->thread_name = name;
+    pthread_mutex_unlock(&s_registry_mutex);
+}
+
+bool Trace_open(const char *path) {
+    FILE *file = fopen(path, "w");
+    if (file == NULL) {
+        return false;
+    }
+    fclose(file);
+
+    pthread_mutex_lock(&s_registry_mutex);
+    snprintf(s_path, sizeof(s_path), "%s", path);
+    pthread_mutex_unlock(&s_registry_mutex);
+    return true;
+}
+
+void Trace_write(void) {
+    pthread_mutex_lock(&s_registry_mutex);
+    FILE *file = s_path[0] != '\0' ? fopen(s_path, "w") : NULL;
+    if (file == NULL) {
+        pthread_mutex_unlock(&s_registry_mutex);
+        return;
+    }
+
+    fprintf(file, "{\"traceEvents\":[\n");
+    fprintf(file, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":0,"
+                  "\"args\":{\"name\":\"tank_client\"}}", PROCESS_ID);
+
+    uint64_t overwritten = 0;
+    TraceEventCopy *copies = malloc(BUFFER_EVENTS * sizeof(TraceEventCopy));
+    for (int b = 0; b < s_buffer_count; b++) {
+        TraceBuffer *buffer = &s_buffers[b];
+        if (buffer->thread_name != NULL) {
+            fprintf(file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,"
+                          "\"args\":{\"name\":\"%s\"}}", PROCESS_ID, buffer->tid, buffer->thread_name);
+        }
+        if (copies == NULL) {
+            continue;
+        }
+
+        // Copy the ring oldest first, then drop any slot the owner may have
+        // started overwriting while we copied it
+        uint64_t end = atomic_load_explicit(&buffer->count, memory_order_acquire);
+        uint64_t first = end > BUFFER_EVENTS ? end - BUFFER_EVENTS : 0;
+        for (uint64_t i = first; i < end; i++) {
+            TraceEvent *e = &buffer->events[i & (BUFFER_EVENTS - 1)];
+            TraceEventCopy *copy = &copies[i - first];
+            copy->name = atomic_load_explicit(&e->name, memory_order_acquire);
+            copy->start_us = atomic_load_explicit(&e->start_us, memory_order_acquire);
+            copy->duration_us = atomic_load_explicit(&e->duration_us, memory_order_acquire);
+        }
+        uint64_t begun = atomic_load_explicit(&buffer->begun, memory_order_relaxed);
+        uint64_t intact = begun > BUFFER_EVENTS ? begun - BUFFER_EVENTS : 0;
+        uint64_t start = first > intact ? first : intact;
+
+        for (uint64_t i = start; i < end; i++) {
+            const TraceEventCopy *e = &copies[i - first];
+            fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%llu,\"dur\":%llu,\"pid\":%d,\"tid\":%d}",
+                    e->name, (unsigned long long) e->start_us, (unsigned long long) e->duration_us,
+                    PROCESS_ID, buffer->tid);
+        }
+        overwritten += start;
+    }
+    free(copies);
+    fprintf(file, "\n]}\n");
+    fclose(file);
+    pthread_mutex_unlock(&s_registry_mutex);
+
+    if (overwritten > 0) {
+        fprintf(stderr, "Trace: kept the newest %u zones per thread, %llu older ones overwritten\n",
+                BUFFER_EVENTS, (unsigned long long) overwritten);
+    }
+}
+
+#else
+
+void Trace_setThreadName(const char *name) {
+    (void) name;
+}
+
+bool Trace_open(const char *path) {
+    (void) path;
+    return false;
+}
+
+void Trace_write(void) {
+}
+
+#endif
@@ -3,14 +3,43 @@
 
 #include <stdbool.h>
 
-// Initialize I2C and accelerometer sensor
+/**
+ * Module for the LIS2DW12 accelerometer on I2C.
+ * - Each sample is one burst read of all six output registers.
+ * - Accelerometer_poll() is registered with the I2C bus manager (i2c_bus.h)
+ *   and publishes the tilt; Accelerometer_getTiltDirection() never touches
+ *   the bus.
+ * - Bus failures are reported through return values; the caller decides
+ *   whether to retry or give up.
+ */
+
+typedef struct {
+    float x;
+    float y;
+    float z;
+} AccelerometerSample;
+
+// Accelerometer polling period on the bus thread; the FIFO holds 320 ms at 100 Hz
+#define ACCELEROMETER_POLL_PERIOD_US 100000
+
+// Initialize the accelerometer sensor (needs I2cBus_open())
 bool Accelerometer_init(void);
 
-// Read raw X, Y, Z accelerometer values
-void Accelerometer_readRaw(float *x, float *y, float *z);
+// Read raw X, Y, Z accelerometer values; false if the bus read failed
+bool Accelerometer_readRaw(float *x, float *y, float *z);
+
+// Queue samples in the sensor's 32-entry FIFO so a slow reader misses none
+bool Accelerometer_enableFifo(bool enable);
+
+// Pop up to max queued samples, oldest first; -1 if the bus read failed
+int Accelerometer_readFifo(AccelerometerSample *samples, int max);
+
+// Read the sensor and publish its tilt (averaged over everything queued when
+// the FIFO is on); false if the bus read failed
+bool Accelerometer_poll(void);
 
-// Read tilt direction
-void Accelerometer_getTiltDirection(float *x_tilt, float *y_tilt);
+// Latest published tilt; false until a poll succeeds or if the last one failed
+bool Accelerometer_getTiltDirection(float *x_tilt, float *y_tilt);
 
 // Cleanup resources
 void Accelerometer_cleanup(void);
@@ -3,6 +3,7 @@
 #define _GPIO_H_
 
 #include <stdbool.h>
+#include <time.h>
 #include <gpiod.h>
 
 /**
@@ -38,6 +39,21 @@ int Gpio_waitForLineChange(struct GpioLine* line1, struct gpiod_line_bulk *bulkE
 bool Gpio_checkForEvent(struct GpioLine* line, struct gpiod_line_bulk *bulkEvents);
 void Gpio_requestEdgeEvents(struct GpioLine* line, enum eGpioEdge edge);
 
+// One edge on a line, stamped by the kernel when it happened (not when read)
+struct GpioEvent {
+    struct GpioLine *line;
+    bool rising;
+    struct timespec timestamp;
+};
+
+#define GPIO_MAX_WAIT_LINES 8
+
+// Block up to timeoutMs (-1 = forever) until any of the lines has edges, then
+// drain every queued edge into events in timestamp order. Lines may be on
+// different chips. Returns the number of events, 0 on timeout or signal.
+int Gpio_waitForEvents(struct GpioLine *lines[], int numLines, int timeoutMs,
+                       struct GpioEvent *events, int maxEvents);
+
 // Utility functions
 void Gpio_close(struct GpioLine* line);
 
@@ -0,0 +1,59 @@
+#ifndef _I2C_BUS_H_
+#define _I2C_BUS_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/**
+ * Module that owns the I2C bus shared by the joystick ADC and the
+ * accelerometer.
+ * - One file descriptor; every transfer names its device address, so there
+ *   is no I2C_SLAVE switching between devices.
+ * - One thread polls each registered device at its own period, so transfers
+ *   never interleave and the sampling cadence is fixed. Drivers publish what
+ *   they read; consumers never touch the bus.
+ * - Counts transfers, errors and time spent on the bus.
+ */
+
+#define I2C_BUS_PATH "/dev/i2c-1"
+
+// Polls one device; false if any transfer failed
+typedef bool (*I2cPollFunction)(void);
+
+typedef struct {
+    const char *name;
+    int period_us;
+    uint64_t polls;
+    uint64_t failures;
+    uint64_t late;             // polls that started a whole period late
+    uint64_t busy_ns;          // time spent inside the poll function
+} I2cDeviceStats;
+
+typedef struct {
+    uint64_t transfers;
+    uint64_t errors;
+    uint64_t bytes;
+    double utilization;        // fraction of time since I2cBus_start() the bus was busy
+} I2cBusStats;
+
+bool I2cBus_open(const char *path);
+void I2cBus_close(void);
+
+// Transfers; safe before I2cBus_start() or from a poll function, which
+// runs on the bus thread. Failures are counted; messages are rate-limited.
+bool I2cBus_write(uint8_t address, uint8_t reg, const uint8_t *values, uint16_t count);
+bool I2cBus_read(uint8_t address, uint8_t reg, uint8_t *values, uint16_t count);
+
+// Register before I2cBus_start(); returns false if the table is full
+bool I2cBus_addDevice(const char *name, int period_us, I2cPollFunction poll);
+
+// Start or stop the polling thread (none is started with no devices)
+bool I2cBus_start(void);
+void I2cBus_stop(void);
+
+// Safe from any thread while polling runs
+void I2cBus_getStats(I2cBusStats *bus, I2cDeviceStats *devices, int *deviceCount);
+void I2cBus_printStats(FILE *out);
+
+#endif
@@ -6,8 +6,16 @@
 
 /**
  * A module for reading the joystick on the beagle bone
+ * - The ADC converts continuously; sample_joystick() collects one axis and
+ *   switches the mux to the other, so X and Y alternate. It is registered
+ *   with the I2C bus manager (i2c_bus.h), which calls it on a fixed period.
+ * - The latest calibrated sample is published lock-free, so read_joystick()
+ *   never touches the bus and can be called from any thread.
  */
 
+// sample_joystick() should run this often; each axis refreshes every other call
+#define JOYSTICK_SAMPLE_PERIOD_US 1000
+
 typedef enum {
     NO_DIRECTION,
     UP,
@@ -22,8 +30,28 @@ typedef struct {
     int16_t y;
 } JoystickOutput;
 
-void init_joystick(void);
+typedef struct {
+    int filter_shift;          // each sample moves 1/2^filter_shift toward the new reading; 0 = unfiltered
+    int dead_zone;             // |x| or |y| at or below this (of 100) reads as 0
+    int direction_threshold;   // |x| or |y| above this (of 100) picks a direction
+} JoystickConfig;
+
+#define JOYSTICK_DEFAULT_FILTER_SHIFT 1
+#define JOYSTICK_DEFAULT_DEAD_ZONE 10
+#define JOYSTICK_DEFAULT_DIRECTION_THRESHOLD 50
+
+// Needs I2cBus_open(); false if the ADC did not accept its config
+bool init_joystick(void);
 void cleanup_joystick(void);
+
+// Safe to call at any time from any thread
+void configure_joystick(const JoystickConfig *config);
+
+// Read the finished conversion, publish it and start the other axis;
+// false if a transfer failed (the last good sample stays published)
+bool sample_joystick(void);
+
+// Latest published sample with dead-zone applied; never blocks
 JoystickOutput read_joystick(void);
 
 
@@ -6,7 +6,8 @@
 
 /**
  * Module for reading a rotary encoder.
- * -
+ * - Edge-driven: RotaryEncoder_processEvents() sleeps in the kernel until
+ *   A, B or the button changes, then decodes every queued edge in order.
  */
 
 // Initialize the rotary encoder hardware
@@ -20,6 +21,8 @@ int RotaryEncoder_readRotation(void);
 
 // Get the button press state (call this periodically)
 bool RotaryEncoder_readButton(void);
-void RotaryEncoder_processEvents(void);  // New function for event processing
+
+// Wait up to timeoutMs for edges and decode them; true if any arrived
+bool RotaryEncoder_processEvents(int timeoutMs);
 
 #endif // _ROTARY_ENCODER_H_
\ No newline at end of file
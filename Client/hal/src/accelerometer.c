@@ -1,130 +1,186 @@
 #include "../include/accelerometer.h"
+#include "../include/i2c_bus.h"
 #include <stdio.h>
-#include <stdlib.h>
-#include <unistd.h>
-#include <fcntl.h>
-#include <sys/ioctl.h>
-#include <linux/i2c-dev.h>
+#include <pthread.h>
 #include <stdint.h>
 #include <math.h>
 
 // I2C Configuration
-#define I2C_BUS "/dev/i2c-1"
 #define ACCELEROMETER_ADDR 0x19
 
 // Accelerometer Registers
-#define REG_WHO_AM_I 0x0F
-#define REG_CTRL1    0x20
-#define REG_OUT_X_L  0x28
-#define REG_OUT_X_H  0x29
-#define REG_OUT_Y_L  0x2A
-#define REG_OUT_Y_H  0x2B
-#define REG_OUT_Z_L  0x2C
-#define REG_OUT_Z_H  0x2D
+#define REG_WHO_AM_I     0x0F
+#define REG_CTRL1        0x20
+#define REG_CTRL2        0x21
+#define REG_OUT_X_L      0x28     // X/Y/Z low/high follow through 0x2D
+#define REG_FIFO_CTRL    0x2E
+#define REG_FIFO_SAMPLES 0x2F
+
+#define CTRL2_BDU        0x08     // Low and high bytes always from the same sample
+#define CTRL2_IF_ADD_INC 0x04     // Burst reads step through the registers
+#define FIFO_MODE_BYPASS     0x00
+#define FIFO_MODE_CONTINUOUS 0xC0 // Keep the newest 32 samples
+#define FIFO_SAMPLES_MASK    0x3F
+#define FIFO_DEPTH           32
 
 // Accelerometer Sensitivity (2g range)
 #define SENSITIVITY  0.004f
 
-static int i2c_fd = -1;
+static bool s_initialized = false;
+static bool s_fifoEnabled = false;
+static AccelerometerSample s_lastSample = {0.0f, 0.0f, 0.0f};
 
-// Internal Helpers
-static int init_i2c_bus(const char *bus, int address) {
-    int fd = open(bus, O_RDWR);
-    if (fd == -1) {
-        perror("I2C: Failed to open bus");
-        return -1;
-    }
+// Tilt published by Accelerometer_poll() for Accelerometer_getTiltDirection()
+static pthread_mutex_t s_tiltMutex = PTHREAD_MUTEX_INITIALIZER;
+static float s_xTilt = 0.0f;
+static float s_yTilt = 0.0f;
+static bool s_tiltValid = false;
 
-    if (ioctl(fd, I2C_SLAVE, address) == -1) {
-        perror("I2C: Failed to set device address");
-        close(fd);
-        return -1;
-    }
-    return fd;
+// Write to an I2C register
+static bool write_i2c_reg(uint8_t reg, uint8_t value) {
+    return I2cBus_write(ACCELEROMETER_ADDR, reg, &value, 1);
 }
 
-// Write to an I2C register
-static void write_i2c_reg(uint8_t reg, uint8_t value) {
-    uint8_t buffer[2] = {reg, value};
-    if (write(i2c_fd, buffer, 2) != 2) {
-        perror("I2C: Failed to write register");
-        exit(EXIT_FAILURE);
+// Read consecutive registers starting at reg in one transaction
+static bool read_i2c_regs(uint8_t reg, uint8_t *values, uint16_t count) {
+    return I2cBus_read(ACCELEROMETER_ADDR, reg, values, count);
+}
+
+// X, Y, Z as little-endian 16-bit pairs, starting at OUT_X_L
+static bool read_sample(AccelerometerSample *sample) {
+    uint8_t raw[6];
+    if (!read_i2c_regs(REG_OUT_X_L, raw, sizeof(raw))) {
+        return false;
     }
+
+    sample->x = (int16_t) ((raw[1] << 8) | raw[0]) * SENSITIVITY;
+    sample->y = (int16_t) ((raw[3] << 8) | raw[2]) * SENSITIVITY;
+    sample->z = (int16_t) ((raw[5] << 8) | raw[4]) * SENSITIVITY;
+    return true;
 }
 
-// Read from an I2C register
-static uint8_t read_i2c_reg(uint8_t reg) {
-    if (write(i2c_fd, &reg, 1) != 1) {
-        perror("I2C: Failed to set read register");
-        exit(EXIT_FAILURE);
+// Public API
+bool Accelerometer_init(void) {
+    uint8_t who_am_i = 0;
+    if (!read_i2c_regs(REG_WHO_AM_I, &who_am_i, 1) || who_am_i != 0x44) {
+        fprintf(stderr, "Accelerometer: Unexpected WHO_AM_I value (0x%02X)\n", who_am_i);
+        return false;
     }
 
-    uint8_t value = 0;
-    if (read(i2c_fd, &value, 1) != 1) {
-        perror("I2C: Failed to read register");
-        exit(EXIT_FAILURE);
+    // Enable accelerometer (100 Hz) with burst-friendly register access
+    if (!write_i2c_reg(REG_CTRL1, 0x50) || !write_i2c_reg(REG_CTRL2, CTRL2_BDU | CTRL2_IF_ADD_INC)) {
+        return false;
     }
-    return value;
+    s_initialized = true;
+    s_fifoEnabled = false;
+    printf("Accelerometer initialized.\n");
+    return true;
 }
 
-// Read 16-bit value from two registers (LSB and MSB)
-static int16_t read_i2c_reg16(uint8_t reg_lsb, uint8_t reg_msb) {
-    int16_t lsb = read_i2c_reg(reg_lsb);
-    int16_t msb = read_i2c_reg(reg_msb);
-    return (int16_t)((msb << 8) | lsb);
+bool Accelerometer_readRaw(float *x, float *y, float *z) {
+    AccelerometerSample sample;
+    if (!read_sample(&sample)) {
+        return false;
+    }
+
+    *x = sample.x;
+    *y = sample.y;
+    *z = sample.z;
+    return true;
 }
 
-// Public API
-bool Accelerometer_init(void) {
-    i2c_fd = init_i2c_bus(I2C_BUS, ACCELEROMETER_ADDR);
-    if (i2c_fd == -1) {
+bool Accelerometer_enableFifo(bool enable) {
+    if (!s_initialized) {
         return false;
     }
 
-    uint8_t who_am_i = read_i2c_reg(REG_WHO_AM_I);
-    if (who_am_i != 0x44) {
-        fprintf(stderr, "Accelerometer: Unexpected WHO_AM_I value (0x%02X)\n", who_am_i);
-        close(i2c_fd);
+    // Passing through bypass empties the FIFO before it starts collecting
+    if (!write_i2c_reg(REG_FIFO_CTRL, FIFO_MODE_BYPASS)) {
         return false;
     }
-
-    // Enable accelerometer
-    write_i2c_reg(REG_CTRL1, 0x50);
-    printf("Accelerometer initialized.\n");
+    if (enable && !write_i2c_reg(REG_FIFO_CTRL, FIFO_MODE_CONTINUOUS)) {
+        return false;
+    }
+    s_fifoEnabled = enable;
     return true;
 }
 
-void Accelerometer_readRaw(float *x, float *y, float *z) {
-    int16_t x_raw = read_i2c_reg16(REG_OUT_X_L, REG_OUT_X_H);
-    int16_t y_raw = read_i2c_reg16(REG_OUT_Y_L, REG_OUT_Y_H);
-    int16_t z_raw = read_i2c_reg16(REG_OUT_Z_L, REG_OUT_Z_H);
+int Accelerometer_readFifo(AccelerometerSample *samples, int max) {
+    uint8_t status = 0;
+    if (!read_i2c_regs(REG_FIFO_SAMPLES, &status, 1)) {
+        return -1;
+    }
+
+    int queued = status & FIFO_SAMPLES_MASK;
+    int count = queued < max ? queued : max;
 
-    *x = x_raw * SENSITIVITY;
-    *y = y_raw * SENSITIVITY;
-    *z = z_raw * SENSITIVITY;
+    // Each burst of the output registers pops one sample
+    for (int i = 0; i < count; i++) {
+        if (!read_sample(&samples[i])) {
+            return -1;
+        }
+    }
+    return count;
 }
 
-void Accelerometer_getTiltDirection(float *x_tilt, float *y_tilt) {
+bool Accelerometer_poll(void) {
     float x, y, z;
-    Accelerometer_readRaw(&x, &y, &z);
+    bool ok = true;
+    if (s_fifoEnabled) {
+        AccelerometerSample samples[FIFO_DEPTH];
+        int count = Accelerometer_readFifo(samples, FIFO_DEPTH);
+        ok = (count >= 0);
+
+        // Average out hand shake; keep the last reading if nothing new arrived
+        if (count > 0) {
+            AccelerometerSample sum = {0.0f, 0.0f, 0.0f};
+            for (int i = 0; i < count; i++) {
+                sum.x += samples[i].x;
+                sum.y += samples[i].y;
+                sum.z += samples[i].z;
+            }
+            s_lastSample.x = sum.x / (float) count;
+            s_lastSample.y = sum.y / (float) count;
+            s_lastSample.z = sum.z / (float) count;
+        }
+        x = s_lastSample.x;
+        y = s_lastSample.y;
+        z = s_lastSample.z;
+    } else {
+        ok = Accelerometer_readRaw(&x, &y, &z);
+    }
+
+    float x_tilt = 0.0f;
+    float y_tilt = 0.0f;
 
     // Normalize based on the magnitude of gravity vector
     float magnitude = sqrt(x*x + y*y + z*z);
-    if (magnitude == 0.0f) {
-        *x_tilt = 0.0f;
-        *y_tilt = 0.0f;
-        return;
+    if (ok && magnitude != 0.0f) {
+        // Normalize and scale to [-1.0, +1.0] based on assignment spec
+        x_tilt = x / magnitude;
+        y_tilt = y / magnitude;
     }
 
-    // Normalize and scale to [-1.0, +1.0] based on assignment spec
-    *x_tilt = x / magnitude;
-    *y_tilt = y / magnitude;
+    pthread_mutex_lock(&s_tiltMutex);
+    if (ok) {
+        s_xTilt = x_tilt;
+        s_yTilt = y_tilt;
+    }
+    s_tiltValid = ok;
+    pthread_mutex_unlock(&s_tiltMutex);
+    return ok;
+}
+
+bool Accelerometer_getTiltDirection(float *x_tilt, float *y_tilt) {
+    pthread_mutex_lock(&s_tiltMutex);
+    bool valid = s_tiltValid;
+    *x_tilt = s_xTilt;
+    *y_tilt = s_yTilt;
+    pthread_mutex_unlock(&s_tiltMutex);
+    return valid;
 }
 
 void Accelerometer_cleanup(void) {
-    if (i2c_fd != -1) {
-        close(i2c_fd);
-        i2c_fd = -1;
-    }
+    s_initialized = false;
     printf("Accelerometer cleaned up.\n");
 }
@@ -4,6 +4,7 @@
 #include <gpiod.h>
 #include <assert.h>
 #include <errno.h>
+#include <poll.h>
 
 // Relies on the gpiod library.
 // Insallation for cross compiling:
@@ -126,4 +127,71 @@ bool Gpio_checkForEvent(struct GpioLine *line, struct gpiod_line_bulk *bulkEvent
     }
 
     return (gpiod_line_bulk_num_lines(bulkEvents) > 0);
-}
\ No newline at end of file
+}
+
+static long long timespecNs(const struct timespec *ts) {
+    return (long long) ts->tv_sec * 1000000000LL + ts->tv_nsec;
+}
+
+int Gpio_waitForEvents(struct GpioLine *lines[], int numLines, int timeoutMs,
+                       struct GpioEvent *events, int maxEvents) {
+    assert(s_isInitialized);
+    assert(numLines <= GPIO_MAX_WAIT_LINES);
+
+    // gpiod_line_event_wait_bulk() only takes lines from one chip, so poll
+    // the event fds directly: one syscall however the lines are spread out.
+    struct pollfd fds[GPIO_MAX_WAIT_LINES];
+    for (int i = 0; i < numLines; i++) {
+        fds[i].fd = gpiod_line_event_get_fd((struct gpiod_line *) lines[i]);
+        fds[i].events = POLLIN | POLLPRI;
+        fds[i].revents = 0;
+    }
+
+    int ready = poll(fds, (nfds_t) numLines, timeoutMs);
+    if (ready == -1) {
+        if (errno == EINTR) {
+            return 0;
+        }
+        perror("Error waiting on lines for events");
+        exit(EXIT_FAILURE);
+    }
+
+    int count = 0;
+    for (int i = 0; i < numLines && ready > 0 && count < maxEvents; i++) {
+        if (!(fds[i].revents & (POLLIN | POLLPRI))) {
+            continue;
+        }
+
+        // The fd is readable, so this returns whatever is queued without blocking
+        struct gpiod_line_event raw[16];
+        unsigned int room = (unsigned int) (maxEvents - count);
+        if (room > sizeof(raw) / sizeof(raw[0])) {
+            room = sizeof(raw) / sizeof(raw[0]);
+        }
+        int n = gpiod_line_event_read_multiple((struct gpiod_line *) lines[i], raw, room);
+        if (n == -1) {
+            perror("Error reading line events");
+            exit(EXIT_FAILURE);
+        }
+
+        for (int j = 0; j < n; j++) {
+            events[count].line = lines[i];
+            events[count].rising = (raw[j].event_type == GPIOD_LINE_EVENT_RISING_EDGE);
+            events[count].timestamp = raw[j].ts;
+            count++;
+        }
+    }
+
+    // Each line's queue is already in order; merge them into one stream
+    for (int i = 1; i < count; i++) {
+        struct GpioEvent event = events[i];
+        int j = i - 1;
+        while (j >= 0 && timespecNs(&events[j].timestamp) > timespecNs(&event.timestamp)) {
+            events[j + 1] = events[j];
+            j--;
+        }
+        events[j + 1] = event;
+    }
+
+    return count;
+}
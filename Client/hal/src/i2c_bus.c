@@ -0,0 +1,307 @@
+#include "../include/i2c_bus.h"
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <sys/ioctl.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+
+#define MAX_DEVICES 4
+#define MAX_WRITE 8
+
+typedef struct {
+    const char *name;
+    int period_us;
+    I2cPollFunction poll;
+    struct timespec next;
+    // Written only by the bus thread, read by I2cBus_getStats()
+    atomic_ullong polls;
+    atomic_ullong failures;
+    atomic_ullong late;
+    atomic_ullong busy_ns;
+} Device;
+
+static int s_fd = -1;
+// Cleared if the adapter rejects I2C_RDWR; then I2C_SLAVE plus write/read are used
+static bool s_combinedTransfers = true;
+static int s_slaveAddress = -1;
+
+static Device s_devices[MAX_DEVICES];
+static int s_deviceCount = 0;
+
+static pthread_t s_thread;
+static atomic_bool s_running = false;
+static struct timespec s_startTime;
+
+static atomic_ullong s_transfers = 0;
+static atomic_ullong s_errors = 0;
+static atomic_ullong s_bytes = 0;
+static atomic_ullong s_busyNs = 0;
+
+// Single-writer counters; a relaxed load and store is enough
+static void bump(atomic_ullong *counter, uint64_t n) {
+    atomic_store_explicit(counter, atomic_load_explicit(counter, memory_order_relaxed) + n,
+                          memory_order_relaxed);
+}
+
+static int64_t elapsed_ns(const struct timespec *from, const struct timespec *to) {
+    return (int64_t) (to->tv_sec - from->tv_sec) * 1000000000LL + (to->tv_nsec - from->tv_nsec);
+}
+
+static void add_us(struct timespec *ts, int us) {
+    ts->tv_nsec += us * 1000L;
+    while (ts->tv_nsec >= 1000000000L) {
+        ts->tv_sec++;
+        ts->tv_nsec -= 1000000000L;
+    }
+}
+
+// A missing device fails every poll, so print the first failure and then
+// only at each power of ten; I2cBus_printStats() has the totals.
+static bool transfer_failed(const char *what) {
+    int error = errno;
+    uint64_t errors = atomic_load_explicit(&s_errors, memory_order_relaxed) + 1;
+    bump(&s_errors, 1);
+
+    uint64_t report = 1;
+    while (report < errors) {
+        report *= 10;
+    }
+    if (report == errors) {
+        if (errors == 1) {
+            fprintf(stderr, "%s: %s\n", what, strerror(error));
+        } else {
+            fprintf(stderr, "%s: %s (%llu I2C errors so far)\n", what, strerror(error),
+                    (unsigned long long) errors);
+        }
+    }
+    return false;
+}
+
+// Fallback path: point the plain read()/write() interface at a device
+static bool select_device(uint8_t address) {
+    if (s_slaveAddress == address) {
+        return true;
+    }
+    if (ioctl(s_fd, I2C_SLAVE, address) == -1) {
+        return transfer_failed("I2C: Failed to set device address");
+    }
+    s_slaveAddress = address;
+    return true;
+}
+
+bool I2cBus_open(const char *path) {
+    s_fd = open(path, O_RDWR);
+    if (s_fd == -1) {
+        perror("I2C: Failed to open bus");
+        return false;
+    }
+    s_combinedTransfers = true;
+    s_slaveAddress = -1;
+    return true;
+}
+
+void I2cBus_close(void) {
+    I2cBus_stop();
+    if (s_fd != -1) {
+        close(s_fd);
+        s_fd = -1;
+    }
+}
+
+bool I2cBus_write(uint8_t address, uint8_t reg, const uint8_t *values, uint16_t count) {
+    if (s_fd == -1 || count >= MAX_WRITE) {
+        return false;
+    }
+
+    uint8_t buffer[MAX_WRITE];
+    buffer[0] = reg;
+    memcpy(&buffer[1], values, count);
+
+    bump(&s_transfers, 1);
+    if (s_combinedTransfers) {
+        struct i2c_msg message = {.addr = address, .flags = 0, .len = (uint16_t) (count + 1), .buf = buffer};
+        struct i2c_rdwr_ioctl_data transfer = {&message, 1};
+        if (ioctl(s_fd, I2C_RDWR, &transfer) == 1) {
+            bump(&s_bytes, count + 1u);
+            return true;
+        }
+        if (errno != EOPNOTSUPP) {
+            return transfer_failed("I2C: Failed to write register");
+        }
+        s_combinedTransfers = false;
+    }
+
+    if (!select_device(address)) {
+        return false;
+    }
+    if (write(s_fd, buffer, count + 1u) != count + 1) {
+        return transfer_failed("I2C: Failed to write register");
+    }
+    bump(&s_bytes, count + 1u);
+    return true;
+}
+
+bool I2cBus_read(uint8_t address, uint8_t reg, uint8_t *values, uint16_t count) {
+    if (s_fd == -1) {
+        return false;
+    }
+
+    bump(&s_transfers, 1);
+    if (s_combinedTransfers) {
+        // Register address and data in one transfer with a repeated start
+        struct i2c_msg messages[2] = {
+                {.addr = address, .flags = 0, .len = 1, .buf = &reg},
+                {.addr = address, .flags = I2C_M_RD, .len = count, .buf = values},
+        };
+        struct i2c_rdwr_ioctl_data transfer = {messages, 2};
+        if (ioctl(s_fd, I2C_RDWR, &transfer) == 2) {
+            bump(&s_bytes, 1u + count);
+            return true;
+        }
+        if (errno != EOPNOTSUPP) {
+            return transfer_failed("I2C: Failed to read registers");
+        }
+        s_combinedTransfers = false;
+    }
+
+    if (!select_device(address)) {
+        return false;
+    }
+    if (write(s_fd, &reg, 1) != 1) {
+        return transfer_failed("I2C: Failed to set read register");
+    }
+    if (read(s_fd, values, count) != count) {
+        return transfer_failed("I2C: Failed to read registers");
+    }
+    bump(&s_bytes, 1u + count);
+    return true;
+}
+
+bool I2cBus_addDevice(const char *name, int period_us, I2cPollFunction poll) {
+    if (s_deviceCount == MAX_DEVICES || s_running) {
+        return false;
+    }
+
+    Device *device = &s_devices[s_deviceCount++];
+    device->name = name;
+    device->period_us = period_us;
+    device->poll = poll;
+    return true;
+}
+
+static void *bus_thread_func(void *arg) {
+    (void) arg;
+
+    while (atomic_load(&s_running)) {
+        // Earliest deadline first; with fixed periods nothing starves
+        Device *due = &s_devices[0];
+        for (int i = 1; i < s_deviceCount; i++) {
+            if (elapsed_ns(&s_devices[i].next, &due->next) > 0) {
+                due = &s_devices[i];
+            }
+        }
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &due->next, NULL);
+
+        struct timespec start;
+        struct timespec end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        bool ok = due->poll();
+        clock_gettime(CLOCK_MONOTONIC, &end);
+
+        uint64_t busy = (uint64_t) elapsed_ns(&start, &end);
+        bump(&due->polls, 1);
+        bump(&due->busy_ns, busy);
+        bump(&s_busyNs, busy);
+        if (!ok) {
+            bump(&due->failures, 1);
+        }
+
+        // After a stall, skip the missed periods instead of bursting through them
+        add_us(&due->next, due->period_us);
+        if (elapsed_ns(&due->next, &end) > due->period_us * 1000LL) {
+            bump(&due->late, 1);
+            due->next = end;
+        }
+    }
+    return NULL;
+}
+
+bool I2cBus_start(void) {
+    if (s_running) {
+        return false;
+    }
+    if (s_deviceCount == 0) {
+        return true;    // nothing answered at init; no thread needed
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &s_startTime);
+    for (int i = 0; i < s_deviceCount; i++) {
+        s_devices[i].next = s_startTime;
+    }
+
+    s_running = true;
+    if (pthread_create(&s_thread, NULL, bus_thread_func, NULL) != 0) {
+        perror("Failed to create I2C bus thread");
+        s_running = false;
+        return false;
+    }
+    return true;
+}
+
+void I2cBus_stop(void) {
+    if (!s_running) {
+        return;
+    }
+    s_running = false;
+    pthread_join(s_thread, NULL);
+    I2cBus_printStats(stderr);
+}
+
+void I2cBus_getStats(I2cBusStats *bus, I2cDeviceStats *devices, int *deviceCount) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    int64_t elapsed = elapsed_ns(&s_startTime, &now);
+
+    bus->transfers = atomic_load_explicit(&s_transfers, memory_order_relaxed);
+    bus->errors = atomic_load_explicit(&s_errors, memory_order_relaxed);
+    bus->bytes = atomic_load_explicit(&s_bytes, memory_order_relaxed);
+    bus->utilization = elapsed > 0
+                       ? (double) atomic_load_explicit(&s_busyNs, memory_order_relaxed) / (double) elapsed
+                       : 0.0;
+
+    for (int i = 0; i < s_deviceCount && i < *deviceCount; i++) {
+        devices[i].name = s_devices[i].name;
+        devices[i].period_us = s_devices[i].period_us;
+        devices[i].polls = atomic_load_explicit(&s_devices[i].polls, memory_order_relaxed);
+        devices[i].failures = atomic_load_explicit(&s_devices[i].failures, memory_order_relaxed);
+        devices[i].late = atomic_load_explicit(&s_devices[i].late, memory_order_relaxed);
+        devices[i].busy_ns = atomic_load_explicit(&s_devices[i].busy_ns, memory_order_relaxed);
+    }
+    if (s_deviceCount < *deviceCount) {
+        *deviceCount = s_deviceCount;
+    }
+}
+
+void I2cBus_printStats(FILE *out) {
+    I2cBusStats bus;
+    I2cDeviceStats devices[MAX_DEVICES];
+    int count = MAX_DEVICES;
+    I2cBus_getStats(&bus, devices, &count);
+
+    fprintf(out, "I2C: %llu transfers, %llu bytes, %llu errors, %.1f%% busy\n",
+            (unsigned long long) bus.transfers, (unsigned long long) bus.bytes,
+            (unsigned long long) bus.errors, bus.utilization * 100.0);
+    for (int i = 0; i < count; i++) {
+        fprintf(out, "I2C:   %-14s every %d us: %llu polls, %llu failed, %llu late, %.1f us avg\n",
+                devices[i].name, devices[i].period_us,
+                (unsigned long long) devices[i].polls, (unsigned long long) devices[i].failures,
+                (unsigned long long) devices[i].late,
+                devices[i].polls > 0 ? (double) devices[i].busy_ns / (double) devices[i].polls / 1000.0 : 0.0);
+    }
+}
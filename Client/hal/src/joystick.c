@@ -1,151 +1,181 @@
 #include "../include/joystick.h"
+#include "../include/i2c_bus.h"
 #include <stdio.h>
-#include <stdlib.h>
-#include <fcntl.h>
-#include <unistd.h>
-#include <sys/ioctl.h>
-#include <linux/i2c-dev.h>
+#include <stdatomic.h>
 
-// I2C Configuration
-#define I2C_BUS "/dev/i2c-1"
+// I2C address of the ADC
+#define ADC_ADDR 0x48
 
 // Register where the ADC data is stored
 #define REG_DATA 0x00
+#define REG_CONFIG 0x01
+
+// ADC Configuration for X and Y channels respectively (byte-swapped: the
+// low byte is sent first and is the config register's high byte):
+// continuous conversion, +/-4.096V, 3300 SPS. At that rate a mux change has
+// settled well inside one JOYSTICK_SAMPLE_PERIOD_US.
+#define TLA2024_CHANNEL_CONF_X 0xC3D2
+#define TLA2024_CHANNEL_CONF_Y 0xC3C2
+
+// Constants for joystick calibration
+#define X_NEUTRAL 833
+#define Y_NEUTRAL 862
+#define X_MAX 1400
+#define X_MIN 400
+#define Y_MAX 1400
+#define Y_MIN 300
+
+enum { AXIS_X, AXIS_Y };
+
+static const uint16_t s_channelConf[2] = {TLA2024_CHANNEL_CONF_X, TLA2024_CHANNEL_CONF_Y};
+
+// Sampler state, only touched by the thread calling sample_joystick()
+static int s_convertingAxis = AXIS_X;
+static int32_t s_filtered[2];      // normalized value << FILTER_FRACTION_BITS
+static bool s_hasSample[2];
+#define FILTER_FRACTION_BITS 8
+
+// Tunables; written by configure_joystick(), read by sampler and readers
+static atomic_int s_filterShift = JOYSTICK_DEFAULT_FILTER_SHIFT;
+static atomic_int s_deadZone = JOYSTICK_DEFAULT_DEAD_ZONE;
+static atomic_int s_directionThreshold = JOYSTICK_DEFAULT_DIRECTION_THRESHOLD;
+
+// Published sample, guarded by a seqlock: the sampler makes s_sampleSeq odd
+// while it writes, readers retry if it was odd or changed underneath them.
+static atomic_uint s_sampleSeq = 0;
+static atomic_int s_sampleX = 0;
+static atomic_int s_sampleY = 0;
+
+// Write to the config register
+static bool write_I2C_reg16(uint16_t value) {
+    // Split 16-bit value into two 8-bit values
+    uint8_t buffer[2] = {value & 0xFF, (value >> 8) & 0xFF};
+    return I2cBus_write(ADC_ADDR, REG_CONFIG, buffer, 2);
+}
 
-// ADC Configuration for X and Y channels respectively
-#define TLA2024_CHANNEL_CONF_X 0x83D2
-#define TLA2024_CHANNEL_CONF_Y 0x83C2
-
-static int I2C_fd = -1;
-
-// Initialize I2C Bus
-static int init_I2C_bus(const char *bus) {
-    int fd = open(bus, O_RDWR);
-    if (fd == -1) {
-        perror("I2C: Failed to open bus");
-        exit(EXIT_FAILURE);
+// Read a 16-bit register value
+static bool read_I2C_reg16(uint8_t reg_addr, uint16_t *value) {
+    uint8_t buffer[2];
+    if (!I2cBus_read(ADC_ADDR, reg_addr, buffer, 2)) {
+        return false;
     }
 
-    // 72 is the address of the ADC
-    if (ioctl(fd, I2C_SLAVE, 72) == -1) {
-        perror("I2C: Failed to set device address");
-        close(fd);
-        exit(EXIT_FAILURE);
-    }
-    return fd;
+    // Combine bytes (the ADC is 12-bit)
+    *value = ((buffer[0] << 8) | buffer[1]) >> 4;
+    return true;
 }
 
-// Write to an I2C register
-static void write_I2C_reg16(int fd, uint16_t value) {
-    uint8_t buffer[3];
+// Map a raw reading onto -100..100 around the calibrated neutral point
+static int normalize(int raw, int neutral, int min, int max) {
+    int value = ((raw - neutral) * 100) / ((raw > neutral) ? (max - neutral) : (neutral - min));
 
+    // Clamp values to ensure they stay within -100 to 100
+    if (value > 100) value = 100;
+    if (value < -100) value = -100;
+    return value;
+}
 
-    buffer[0] = 1;
+static void publish_sample(int x, int y) {
+    unsigned seq = atomic_load_explicit(&s_sampleSeq, memory_order_relaxed);
+    atomic_store_explicit(&s_sampleSeq, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
 
-    // Split 16-bit value into two 8-bit values
-    buffer[1] = (value & 0xFF);
-    buffer[2] = (value >> 8) & 0xFF;
+    atomic_store_explicit(&s_sampleX, x, memory_order_relaxed);
+    atomic_store_explicit(&s_sampleY, y, memory_order_relaxed);
 
-    if (write(fd, buffer, 3) != 3) {
-        perror("I2C: Failed to write register");
-        exit(EXIT_FAILURE);
-    }
+    atomic_store_explicit(&s_sampleSeq, seq + 2, memory_order_release);
 }
 
-// Read a 16-bit register value
-static uint16_t read_I2C_reg16(int fd, uint8_t reg_addr) {
-    if (write(fd, &reg_addr, 1) != 1) {
-        perror("I2C: Failed to set read register");
-        exit(EXIT_FAILURE);
-    }
-
-    uint8_t buffer[2];
-    if (read(fd, buffer, 2) != 2) {
-        perror("I2C: Failed to read register");
-        exit(EXIT_FAILURE);
-    }
-
-    // Combine bytes (the ADC is 12-bit)
-    return ((buffer[0] << 8) | buffer[1]) >> 4;
+static int apply_dead_zone(int value, int deadZone) {
+    return (value >= -deadZone && value <= deadZone) ? 0 : value;
 }
 
 // **Initialize Joystick**
-void init_joystick(void) {
-    if (I2C_fd == -1) {
-        I2C_fd = init_I2C_bus(I2C_BUS);
-    }
-
-    // Configure ADC channels
-    write_I2C_reg16(I2C_fd, TLA2024_CHANNEL_CONF_X);
-    usleep(10000);
-    write_I2C_reg16(I2C_fd, TLA2024_CHANNEL_CONF_Y);
-    usleep(10000);
+bool init_joystick(void) {
+    // Start converting X; the first sample_joystick() collects it
+    s_convertingAxis = AXIS_X;
+    s_hasSample[AXIS_X] = false;
+    s_hasSample[AXIS_Y] = false;
+    publish_sample(0, 0);
+    return write_I2C_reg16(s_channelConf[AXIS_X]);
 }
 
 // **Cleanup Joystick**
 void cleanup_joystick(void) {
     fprintf(stderr, "Cleaning up joystick module...\n");
-    if (I2C_fd != -1) {
-        close(I2C_fd);
-        I2C_fd = -1;
-    }
 }
 
-// **Read Joystick and Determine Direction**
-JoystickOutput read_joystick(void) {
-    JoystickOutput output = {NO_DIRECTION, 0, 0};
+void configure_joystick(const JoystickConfig *config) {
+    int shift = config->filter_shift < 0 ? 0 : config->filter_shift;
+    atomic_store(&s_filterShift, shift > 8 ? 8 : shift);   // 256 samples is already sluggish
+    atomic_store(&s_deadZone, config->dead_zone < 0 ? 0 : config->dead_zone);
+    atomic_store(&s_directionThreshold, config->direction_threshold);
+}
 
-    // Case where joystick is not initialized
-    if (I2C_fd == -1) {
-        fprintf(stderr, "Joystick module not initialized!\n");
-        return output;
+// **Sample One Axis**
+bool sample_joystick(void) {
+    int axis = s_convertingAxis;
+    uint16_t raw;
+    if (!read_I2C_reg16(REG_DATA, &raw)) {
+        return false;   // keep publishing the last good sample
     }
 
-    // Read raw X and Y values
-    write_I2C_reg16(I2C_fd, TLA2024_CHANNEL_CONF_X);
-    usleep(10000);
-    uint16_t raw_x = read_I2C_reg16(I2C_fd, REG_DATA);
-
-    write_I2C_reg16(I2C_fd, TLA2024_CHANNEL_CONF_Y);
-    usleep(10000);
-    uint16_t raw_y = read_I2C_reg16(I2C_fd, REG_DATA);
-
-
-    // Constants for joystick calibration
-    const int X_NEUTRAL = 833;
-    const int Y_NEUTRAL = 862;
-    const int X_MAX = 1400;
-    const int X_MIN = 400;
-    const int Y_MAX = 1400;
-    const int Y_MIN = 300;
-
+    // Switch the mux first so the other axis converts while we publish this one
+    s_convertingAxis = (axis == AXIS_X) ? AXIS_Y : AXIS_X;
+    if (!write_I2C_reg16(s_channelConf[s_convertingAxis])) {
+        s_convertingAxis = axis;
+        return false;
+    }
 
-    // Normalize raw values to -100 to 100
-    int normalized_x = ((raw_x - X_NEUTRAL) * 100) /
-                       ((raw_x > X_NEUTRAL) ? (X_MAX - X_NEUTRAL) : (X_NEUTRAL - X_MIN));
+    // Y reads high when the stick is pushed down
+    int value = (axis == AXIS_X) ? normalize(raw, X_NEUTRAL, X_MIN, X_MAX)
+                                 : -normalize(raw, Y_NEUTRAL, Y_MIN, Y_MAX);
+
+    // Exponential smoothing in fixed point; the first reading seeds it
+    int32_t target = (int32_t) value << FILTER_FRACTION_BITS;
+    if (!s_hasSample[axis]) {
+        s_filtered[axis] = target;
+        s_hasSample[axis] = true;
+    } else {
+        s_filtered[axis] += (target - s_filtered[axis]) / (1 << atomic_load_explicit(&s_filterShift, memory_order_relaxed));
+    }
 
-    int normalized_y = ((Y_NEUTRAL - raw_y) * 100) /
-                       ((raw_y < Y_NEUTRAL) ? (Y_NEUTRAL - Y_MIN) : (Y_MAX - Y_NEUTRAL));
+    publish_sample(s_filtered[AXIS_X] / (1 << FILTER_FRACTION_BITS),
+                   s_filtered[AXIS_Y] / (1 << FILTER_FRACTION_BITS));
+    return true;
+}
 
+// **Read Joystick and Determine Direction**
+JoystickOutput read_joystick(void) {
+    JoystickOutput output = {NO_DIRECTION, 0, 0};
 
-    // Clamp values to ensure they stay within -100 to 100
-    if (normalized_x > 100) normalized_x = 100;
-    if (normalized_x < -100) normalized_x = -100;
-    if (normalized_y > 100) normalized_y = 100;
-    if (normalized_y < -100) normalized_y = -100;
+    unsigned begin;
+    unsigned end;
+    int x;
+    int y;
+    do {
+        begin = atomic_load_explicit(&s_sampleSeq, memory_order_acquire);
+        x = atomic_load_explicit(&s_sampleX, memory_order_relaxed);
+        y = atomic_load_explicit(&s_sampleY, memory_order_relaxed);
+        atomic_thread_fence(memory_order_acquire);
+        end = atomic_load_explicit(&s_sampleSeq, memory_order_relaxed);
+    } while ((begin & 1u) != 0 || begin != end);
+
+    int deadZone = atomic_load_explicit(&s_deadZone, memory_order_relaxed);
+    int threshold = atomic_load_explicit(&s_directionThreshold, memory_order_relaxed);
 
     // Assign normalized values to output struct
-    output.x = (int16_t) normalized_x;
-    output.y = (int16_t) normalized_y;
+    output.x = (int16_t) apply_dead_zone(x, deadZone);
+    output.y = (int16_t) apply_dead_zone(y, deadZone);
 
     // Determine direction based on normalized values
-    if (output.y > 50) {
+    if (output.y > threshold) {
         output.direction = UP;
-    } else if (output.y < -50) {
+    } else if (output.y < -threshold) {
         output.direction = DOWN;
-    } else if (output.x > 50) {
+    } else if (output.x > threshold) {
         output.direction = RIGHT;
-    } else if (output.x < -50) {
+    } else if (output.x < -threshold) {
         output.direction = LEFT;
     }
 
@@ -14,27 +14,21 @@ static struct GpioLine *s_lineA = NULL;
 static struct GpioLine *s_lineB = NULL;
 static struct GpioLine *s_lineButton = NULL;
 
-// Rotary Encoder State Machine
-typedef void (*ActionFn)(void);
-
-struct stateEvent {
-    struct state *pNextState;
-    ActionFn action;
-};
-
-struct state {
-    struct stateEvent a_rising;
-    struct stateEvent a_falling;
-    struct stateEvent b_rising;
-    struct stateEvent b_falling;
-};
-
-enum {
-    ST_REST = 0, ST_1, ST_2, ST_3, NUM_STATES
+// Quadrature decoding. The encoder rests with A and B high (state 0b11);
+// one detent clockwise walks 11 -> 01 -> 00 -> 10 -> 11 (A leads B).
+// Index with (previous << 2) | current, where state = (A << 1) | B. Contact
+// bounce on one line is a pair of opposite quarter steps that cancel, so A
+// and B need no time-based debounce (which would also eat fast spins).
+static const signed char QUADRATURE_STEP[16] = {
+     0, -1,  1,  0,
+     1,  0,  0, -1,
+    -1,  0,  0,  1,
+     0,  1, -1,  0
 };
+#define STATE_REST 0x3
 
-static struct state states[NUM_STATES];
-static struct state *pCurrentState = &states[ST_REST];
+static int s_quadratureState = STATE_REST;
+static int s_quarterSteps = 0;
 static volatile int s_rotationDelta = 0;
 
 // Button state variables
@@ -42,54 +36,56 @@ static volatile bool s_buttonPressed = false;
 static volatile bool s_buttonStateChanged = false;
 static volatile bool s_buttonHandled = true;
 
-// Debouncing variables
-static struct timespec s_lastAEvent = {0, 0};
-static struct timespec s_lastBEvent = {0, 0};
+// Debouncing, measured between kernel edge timestamps
 static struct timespec s_lastButtonEvent = {0, 0};
 #define DEBOUNCE_NS 5000000  // 5ms debounce time
 
-// Transition functions for rotary encoder
-static void onClockwise(void) {
-    s_rotationDelta++;
-}
+// Rotary and button edges queued since the last wait; the kernel keeps 16 per line
+#define MAX_EVENTS 48
+
+static void onEncoderEdge(const struct GpioEvent *event) {
+    int bit = (event->line == s_lineA) ? 0x2 : 0x1;
+    int next = event->rising ? (s_quadratureState | bit) : (s_quadratureState & ~bit);
+    if (next == s_quadratureState) {
+        return;
+    }
 
-static void onCounterClockwise(void) {
-    s_rotationDelta--;
+    s_quarterSteps += QUADRATURE_STEP[(s_quadratureState << 2) | next];
+    s_quadratureState = next;
+
+    // Count a detent on reaching rest; allow one lost quarter step
+    if (next == STATE_REST) {
+        if (s_quarterSteps >= 2) {
+            s_rotationDelta++;
+        } else if (s_quarterSteps <= -2) {
+            s_rotationDelta--;
+        }
+        s_quarterSteps = 0;
+    }
 }
 
-static void doNothing(void) {}
-
-static void initStates(void) {
-    // REST state
-    states[ST_REST].a_rising = (struct stateEvent) {&states[ST_REST], doNothing};
-    states[ST_REST].a_falling = (struct stateEvent) {&states[ST_1], doNothing};
-    states[ST_REST].b_rising = (struct stateEvent) {&states[ST_REST], doNothing};
-    states[ST_REST].b_falling = (struct stateEvent) {&states[ST_3], doNothing};
-
-    // S1
-    states[ST_1].a_rising = (struct stateEvent) {&states[ST_REST], onCounterClockwise};
-    states[ST_1].a_falling = (struct stateEvent) {&states[ST_1], doNothing};
-    states[ST_1].b_rising = (struct stateEvent) {&states[ST_1], doNothing};
-    states[ST_1].b_falling = (struct stateEvent) {&states[ST_2], doNothing};
-
-    // S2
-    states[ST_2].a_rising = (struct stateEvent) {&states[ST_3], doNothing};
-    states[ST_2].a_falling = (struct stateEvent) {&states[ST_2], doNothing};
-    states[ST_2].b_rising = (struct stateEvent) {&states[ST_1], doNothing};
-    states[ST_2].b_falling = (struct stateEvent) {&states[ST_2], doNothing};
-
-    // S3
-    states[ST_3].a_rising = (struct stateEvent) {&states[ST_3], doNothing};
-    states[ST_3].a_falling = (struct stateEvent) {&states[ST_2], doNothing};
-    states[ST_3].b_rising = (struct stateEvent) {&states[ST_REST], onClockwise};
-    states[ST_3].b_falling = (struct stateEvent) {&states[ST_3], doNothing};
+static void onButtonEdge(const struct GpioEvent *event) {
+    long long sinceLast = (long long) (event->timestamp.tv_sec - s_lastButtonEvent.tv_sec) * 1000000000LL +
+                          (event->timestamp.tv_nsec - s_lastButtonEvent.tv_nsec);
+    if (sinceLast <= DEBOUNCE_NS) {
+        return;
+    }
+    s_lastButtonEvent = event->timestamp;
+
+    bool currentState = !event->rising; // Active-low button
+
+    // Only register new presses if button was released since last press
+    if (currentState && (!s_buttonPressed || s_buttonHandled)) {
+        s_buttonPressed = true;
+        s_buttonStateChanged = true;
+        s_buttonHandled = false;
+    } else if (!currentState) {
+        s_buttonPressed = false;
+        s_buttonHandled = true;
+    }
 }
 
 void RotaryEncoder_init(void) {
-    // Build the state table once
-    initStates();
-    pCurrentState = &states[ST_REST];
-
     // Open lines for input with edge detection
     s_lineA = Gpio_openForEvents(ENCODER_CHIP, PIN_A);
     s_lineB = Gpio_openForEvents(ENCODER_CHIP, PIN_B);
@@ -100,6 +96,11 @@ void RotaryEncoder_init(void) {
     Gpio_requestEdgeEvents(s_lineB, GPIO_EDGE_BOTH);
     Gpio_requestEdgeEvents(s_lineButton, GPIO_EDGE_BOTH);
 
+    // Start decoding from wherever the shaft is sitting
+    s_quadratureState = (gpiod_line_get_value((struct gpiod_line*)s_lineA) > 0 ? 0x2 : 0) |
+                        (gpiod_line_get_value((struct gpiod_line*)s_lineB) > 0 ? 0x1 : 0);
+    s_quarterSteps = 0;
+
     // Initialize state variables
     s_rotationDelta = 0;
     s_buttonPressed = false;
@@ -122,69 +123,19 @@ void RotaryEncoder_cleanup(void) {
     }
 }
 
-void RotaryEncoder_processEvents(void) {
-    struct gpiod_line_bulk bulkEvents;
-    struct timespec now;
-    clock_gettime(CLOCK_MONOTONIC, &now);
-
-    // Check for changes on line A
-    if (Gpio_checkForEvent(s_lineA, &bulkEvents)) {
-        long time_since_last = (now.tv_sec - s_lastAEvent.tv_sec) * 1000000000L +
-                               (now.tv_nsec - s_lastAEvent.tv_nsec);
-
-        if (time_since_last > DEBOUNCE_NS) {
-            int a_val = gpiod_line_get_value((struct gpiod_line*)s_lineA);
-            if (a_val) {
-                if (pCurrentState->a_rising.action) pCurrentState->a_rising.action();
-                pCurrentState = pCurrentState->a_rising.pNextState;
-            } else {
-                if (pCurrentState->a_falling.action) pCurrentState->a_falling.action();
-                pCurrentState = pCurrentState->a_falling.pNextState;
-            }
-            s_lastAEvent = now;
-        }
-    }
-
-    // Check for changes on line B
-    if (Gpio_checkForEvent(s_lineB, &bulkEvents)) {
-        long time_since_last = (now.tv_sec - s_lastBEvent.tv_sec) * 1000000000L +
-                               (now.tv_nsec - s_lastBEvent.tv_nsec);
-
-        if (time_since_last > DEBOUNCE_NS) {
-            int b_val = gpiod_line_get_value((struct gpiod_line*)s_lineB);
-            if (b_val) {
-                if (pCurrentState->b_rising.action) pCurrentState->b_rising.action();
-                pCurrentState = pCurrentState->b_rising.pNextState;
-            } else {
-                if (pCurrentState->b_falling.action) pCurrentState->b_falling.action();
-                pCurrentState = pCurrentState->b_falling.pNextState;
-            }
-            s_lastBEvent = now;
-        }
-    }
+bool RotaryEncoder_processEvents(int timeoutMs) {
+    struct GpioLine *lines[] = {s_lineA, s_lineB, s_lineButton};
+    struct GpioEvent events[MAX_EVENTS];
 
-    // Check for button changes
-    if (Gpio_checkForEvent(s_lineButton, &bulkEvents)) {
-        long time_since_last = (now.tv_sec - s_lastButtonEvent.tv_sec) * 1000000000L +
-                              (now.tv_nsec - s_lastButtonEvent.tv_nsec);
-
-        if (time_since_last > DEBOUNCE_NS) {
-            int button_val = gpiod_line_get_value((struct gpiod_line*)s_lineButton);
-            bool currentState = (button_val == 0); // Assuming active-low button
-
-            // Only register new presses if button was released since last press
-            if (currentState && (!s_buttonPressed || s_buttonHandled)) {
-                s_buttonPressed = true;
-                s_buttonStateChanged = true;
-                s_buttonHandled = false;
-            } else if (!currentState) {
-                s_buttonPressed = false;
-                s_buttonHandled = true;
-            }
-
-            s_lastButtonEvent = now;
+    int count = Gpio_waitForEvents(lines, 3, timeoutMs, events, MAX_EVENTS);
+    for (int i = 0; i < count; i++) {
+        if (events[i].line == s_lineButton) {
+            onButtonEdge(&events[i]);
+        } else {
+            onEncoderEdge(&events[i]);
         }
     }
+    return count > 0;
 }
 
 int RotaryEncoder_readRotation(void) {
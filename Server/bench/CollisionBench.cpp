@@ -0,0 +1,120 @@
+#include "../include/SpatialGrid.h"
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+/**
+ * Microbenchmark for projectile/enemy collision: the original nested loops
+ * (sqrt per pair) against the SpatialGrid broadphase (squared distances).
+ *
+ * Usage: CollisionBench [projectiles] [enemies] [iterations]
+ */
+
+namespace {
+
+struct Point {
+    float x, y;
+};
+
+constexpr float ARENA_W = 1024.0f;
+constexpr float ARENA_H = 768.0f;
+constexpr float ENEMY_RADIUS = 20.0f;
+
+// Same shape as the pre-broadphase GameState::checkProjectileCollisions
+int nestedLoops(const std::vector<Point> &projectiles, const std::vector<Point> &enemies,
+                std::vector<char> &enemyHit) {
+    int hits = 0;
+    std::fill(enemyHit.begin(), enemyHit.end(), 0);
+    for (const auto &p: projectiles) {
+        for (size_t e = 0; e < enemies.size(); ++e) {
+            if (enemyHit[e]) continue;
+            float dx = p.x - enemies[e].x;
+            float dy = p.y - enemies[e].y;
+            float distance = std::sqrt(dx * dx + dy * dy);
+            if (distance < ENEMY_RADIUS) {
+                enemyHit[e] = 1;
+                hits++;
+                break;
+            }
+        }
+    }
+    return hits;
+}
+
+int broadphase(SpatialGrid &grid, const std::vector<Point> &projectiles,
+               const std::vector<Point> &enemies, std::vector<char> &projectileHit) {
+    grid.clear();
+    for (size_t i = 0; i < projectiles.size(); ++i) {
+        grid.insert(static_cast<int>(i), projectiles[i].x, projectiles[i].y);
+    }
+    grid.build();
+    projectileHit.assign(projectiles.size(), 0);
+
+    int hits = 0;
+    for (const auto &e: enemies) {
+        int firstHit = -1;
+        grid.query(e.x, e.y, ENEMY_RADIUS, [&](int id) {
+            if (!projectileHit[id] && (firstHit < 0 || id < firstHit)) {
+                firstHit = id;
+            }
+        });
+        if (firstHit >= 0) {
+            projectileHit[firstHit] = 1;
+            hits++;
+        }
+    }
+    return hits;
+}
+
+template<typename Fn>
+double timePerIteration(int iterations, Fn &&fn) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        fn();
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    int projectileCount = argc > 1 ? std::atoi(argv[1]) : 500;
+    int enemyCount = argc > 2 ? std::atoi(argv[2]) : 50;
+    int iterations = argc > 3 ? std::atoi(argv[3]) : 2000;
+
+    std::mt19937 rng(433);
+    std::uniform_real_distribution<float> xDist(0.0f, ARENA_W);
+    std::uniform_real_distribution<float> yDist(0.0f, ARENA_H);
+
+    std::vector<Point> projectiles(projectileCount);
+    std::vector<Point> enemies(enemyCount);
+    for (auto &p: projectiles) p = {xDist(rng), yDist(rng)};
+    for (auto &e: enemies) e = {xDist(rng), yDist(rng)};
+
+    SpatialGrid grid(ARENA_W, ARENA_H, 64.0f);
+    std::vector<char> enemyHit(enemies.size());
+    std::vector<char> projectileHit;
+
+    volatile int sink = 0;
+    double naiveNs = timePerIteration(iterations, [&]() {
+        sink = sink + nestedLoops(projectiles, enemies, enemyHit);
+    });
+    double gridNs = timePerIteration(iterations, [&]() {
+        sink = sink + broadphase(grid, projectiles, enemies, projectileHit);
+    });
+
+    int naiveHits = nestedLoops(projectiles, enemies, enemyHit);
+    int gridHits = broadphase(grid, projectiles, enemies, projectileHit);
+
+    std::cout << "projectiles=" << projectileCount
+              << " enemies=" << enemyCount
+              << " iterations=" << iterations << std::endl;
+    std::cout << "nested loops: " << naiveNs << " ns/tick (" << naiveHits << " hits)" << std::endl;
+    std::cout << "spatial grid: " << gridNs << " ns/tick (" << gridHits << " hits)" << std::endl;
+    std::cout << "speedup:      " << naiveNs / gridNs << "x" << std::endl;
+    return 0;
+}
@@ -0,0 +1,225 @@
+#include "../include/GameState.h"
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+/**
+ * Whole-tick benchmark: drives GameState::step() directly (no network, no
+ * window) under synthetic load and reports per-tick time percentiles, heap
+ * allocations per tick and entity throughput.
+ *
+ * Usage: SimulationBench [ticks] [profile...]
+ *   profile is a name below or "wave,shotsPerSecond" (e.g. 120,15);
+ *   default runs every named profile.
+ *
+ * The starting wave sets the enemy count (1 + wave/5 to 5 + wave/5). The
+ * player stands still, sweeps the turret and fires at the given rate, and
+ * is healed every tick so the load does not stop when the tank dies.
+ */
+
+namespace {
+
+// Heap allocations made by the benchmark loop; counted in operator new
+std::size_t allocationCount = 0;
+std::size_t allocationBytes = 0;
+
+struct Profile {
+    std::string name;
+    int wave;
+    double shotsPerSecond;
+};
+
+const Profile PROFILES[] = {
+        {"idle",  0,   0.0},
+        {"light", 5,   2.0},
+        {"heavy", 60,  10.0},
+        {"swarm", 250, 30.0},
+};
+
+constexpr double TICK_RATE = 60.0;
+constexpr int WARMUP_TICKS = 60;
+constexpr std::uint32_t SEED = 433;
+
+bool parseProfile(const char *arg, Profile &out) {
+    for (const auto &p: PROFILES) {
+        if (p.name == arg) {
+            out = p;
+            return true;
+        }
+    }
+    const char *comma = std::strchr(arg, ',');
+    if (!comma) return false;
+    out = {arg, std::atoi(arg), std::atof(comma + 1)};
+    return true;
+}
+
+double percentile(const std::vector<double> &sorted, double p) {
+    if (sorted.empty()) return 0.0;
+    auto i = static_cast<std::size_t>(p * static_cast<double>(sorted.size() - 1) + 0.5);
+    return sorted[i];
+}
+
+void run(const Profile &profile, int ticks) {
+    GameState state(SEED);
+    state.startWave(profile.wave);
+
+    auto dt = static_cast<float>(1.0 / TICK_RATE);
+    double shotsPerTick = profile.shotsPerSecond / TICK_RATE;
+    double shotCredit = 0.0;
+
+    std::vector<double> tickNs;
+    tickNs.reserve(ticks);
+    std::size_t allocations = 0;
+    std::size_t bytes = 0;
+    std::uint64_t entityTicks = 0;
+    double totalNs = 0.0;
+
+    for (int t = -WARMUP_TICKS; t < ticks; ++t) {
+        TickInput input;
+        input.rotationDelta = 1;
+        input.restoreHealth = true;
+        shotCredit += shotsPerTick;
+        if (shotCredit >= 1.0) {
+            input.fire = true;
+            shotCredit -= 1.0;
+        }
+
+        std::size_t allocationsBefore = allocationCount;
+        std::size_t bytesBefore = allocationBytes;
+        auto start = std::chrono::steady_clock::now();
+        state.step(input, dt);
+        auto end = std::chrono::steady_clock::now();
+
+        if (t < 0) continue;
+        double ns = std::chrono::duration<double, std::nano>(end - start).count();
+        tickNs.push_back(ns);
+        totalNs += ns;
+        allocations += allocationCount - allocationsBefore;
+        bytes += allocationBytes - bytesBefore;
+        entityTicks += static_cast<std::size_t>(state.getEnemies().size() + state.getProjectiles().size());
+    }
+
+    std::sort(tickNs.begin(), tickNs.end());
+    double perTick = 1.0 / std::max(1, ticks);
+
+    std::cout << std::left << std::setw(10) << profile.name << std::right << std::fixed << std::setprecision(0)
+              << " p50 " << std::setw(7) << percentile(tickNs, 0.50)
+              << " p90 " << std::setw(7) << percentile(tickNs, 0.90)
+              << " p99 " << std::setw(7) << percentile(tickNs, 0.99)
+              << " p99.9 " << std::setw(7) << percentile(tickNs, 0.999)
+              << " max " << std::setw(7) << (tickNs.empty() ? 0.0 : tickNs.back()) << " ns"
+              << std::setprecision(2)
+              << " | allocs/tick " << std::setw(6) << static_cast<double>(allocations) * perTick
+              << " (" << std::setprecision(0) << static_cast<double>(bytes) * perTick << " B)"
+              << std::setprecision(1)
+              << " | entities/tick " << std::setw(6) << static_cast<double>(entityTicks) * perTick
+              << " | " << std::setprecision(2)
+              << (totalNs > 0.0 ? static_cast<double>(entityTicks) * 1e3 / totalNs : 0.0) << " M entity-ticks/s"
+              << " | end wave " << state.getCurrentWave() << std::endl;
+}
+
+} // namespace
+
+namespace {
+
+void *countedAlloc(std::size_t size, std::size_t alignment) {
+    ++allocationCount;
+    allocationBytes += size;
+    if (size == 0) size = 1;
+    if (alignment <= alignof(std::max_align_t)) return std::malloc(size);
+    // aligned_alloc wants the size to be a multiple of the alignment
+    return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+}
+
+void *countedAllocOrThrow(std::size_t size, std::size_t alignment) {
+    if (void *p = countedAlloc(size, alignment)) return p;
+    throw std::bad_alloc();
+}
+
+} // namespace
+
+// Every replaceable form, so allocations/tick cannot under-count. All of them
+// hand out malloc'd memory and free() it, which GCC cannot see through.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+
+void *operator new(std::size_t size) {
+    return countedAllocOrThrow(size, 0);
+}
+
+void *operator new[](std::size_t size) {
+    return countedAllocOrThrow(size, 0);
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment) {
+    return countedAllocOrThrow(size, static_cast<std::size_t>(alignment));
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment) {
+    return countedAllocOrThrow(size, static_cast<std::size_t>(alignment));
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept {
+    return countedAlloc(size, 0);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept {
+    return countedAlloc(size, 0);
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+    return countedAlloc(size, static_cast<std::size_t>(alignment));
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+    return countedAlloc(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t) noexcept { std::free(p); }
+void operator delete(void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void *p, const std::nothrow_t &) noexcept { std::free(p); }
+void operator delete[](void *p, const std::nothrow_t &) noexcept { std::free(p); }
+void operator delete(void *p, std::align_val_t, const std::nothrow_t &) noexcept { std::free(p); }
+void operator delete[](void *p, std::align_val_t, const std::nothrow_t &) noexcept { std::free(p); }
+
+#pragma GCC diagnostic pop
+
+int main(int argc, char *argv[]) {
+    int ticks = argc > 1 ? std::atoi(argv[1]) : 3600;
+
+    std::vector<Profile> profiles;
+    for (int i = 2; i < argc; ++i) {
+        Profile p;
+        if (!parseProfile(argv[i], p)) {
+            std::cerr << "Unknown profile: " << argv[i] << std::endl;
+            return EXIT_FAILURE;
+        }
+        profiles.push_back(p);
+    }
+    if (profiles.empty()) {
+        profiles.assign(std::begin(PROFILES), std::end(PROFILES));
+    }
+
+    std::cout << "ticks=" << ticks << " (+" << WARMUP_TICKS << " warm-up) at " << TICK_RATE
+              << " Hz, seed " << SEED << std::endl;
+#if defined(__SANITIZE_ADDRESS__) || defined(__SANITIZE_THREAD__)
+    std::cout << "note: built with a sanitizer; timings are not representative" << std::endl;
+#endif
+    for (const auto &p: profiles) {
+        run(p, ticks);
+    }
+    return 0;
+}
@@ -0,0 +1,75 @@
+# Build profiles for the server and its benchmarks, selected with
+# CMAKE_BUILD_TYPE (or a preset from CMakePresets.json):
+#
+#   Release         -O3, link-time optimization, optional -march (default)
+#   RelWithDebInfo  -O2 -g
+#   Debug           -O0 -g
+#   ASan            AddressSanitizer + UndefinedBehaviorSanitizer
+#   TSan            ThreadSanitizer
+#
+# Profile-guided optimization sits on top of Release in one build tree:
+# configure with TANK_PGO=GENERATE, build, run the pgo-train target, then
+# reconfigure with TANK_PGO=USE and build again.
+
+include(CheckIPOSupported)
+
+if(NOT CMAKE_BUILD_TYPE AND NOT CMAKE_CONFIGURATION_TYPES)
+    set(CMAKE_BUILD_TYPE Release CACHE STRING "Build profile" FORCE)
+endif()
+set_property(CACHE CMAKE_BUILD_TYPE PROPERTY STRINGS Release RelWithDebInfo Debug ASan TSan)
+
+option(TANK_LTO "Link-time optimization in Release builds" ON)
+set(TANK_MARCH "" CACHE STRING "-march for Release builds, e.g. native (empty = compiler default)")
+set(TANK_PGO OFF CACHE STRING "Profile-guided optimization: OFF, GENERATE or USE")
+set_property(CACHE TANK_PGO PROPERTY STRINGS OFF GENERATE USE)
+set(TANK_PGO_DIR "${CMAKE_BINARY_DIR}/pgo-data" CACHE PATH "Where PGO profiles are written and read")
+
+# Sanitizer runtimes must be linked as well as compiled in
+set(TANK_ASAN_FLAGS -fsanitize=address,undefined -fno-omit-frame-pointer -g -O1)
+set(TANK_TSAN_FLAGS -fsanitize=thread -g -O1)
+
+if(TANK_LTO)
+    check_ipo_supported(RESULT TANK_IPO_SUPPORTED OUTPUT TANK_IPO_ERROR LANGUAGES CXX)
+    if(NOT TANK_IPO_SUPPORTED)
+        message(STATUS "LTO not supported by this toolchain: ${TANK_IPO_ERROR}")
+    endif()
+endif()
+
+if(CMAKE_CXX_COMPILER_ID MATCHES "Clang")
+    # Clang writes raw profiles; pgo-train merges them into one file
+    find_program(TANK_LLVM_PROFDATA NAMES llvm-profdata)
+    set(TANK_PGO_USE_FLAGS -fprofile-use=${TANK_PGO_DIR}/default.profdata -Wno-profile-instr-unprofiled)
+else()
+    # Threads make the counters slightly inconsistent; code a short training
+    # run never reached is expected, not an error
+    set(TANK_PGO_USE_FLAGS -fprofile-use=${TANK_PGO_DIR} -fprofile-correction -Wno-missing-profile)
+endif()
+
+# Target-level options come after the parent directory's add_compile_options
+# (-O2), so the profile's optimization level is the one that applies
+function(tank_apply_build_profile target)
+    target_compile_options(${target} PRIVATE
+            $<$<CONFIG:Release>:-O3>
+            $<$<CONFIG:ASan>:${TANK_ASAN_FLAGS}>
+            $<$<CONFIG:TSan>:${TANK_TSAN_FLAGS}>)
+    target_link_libraries(${target}
+            $<$<CONFIG:ASan>:-fsanitize=address,undefined>
+            $<$<CONFIG:TSan>:-fsanitize=thread>)
+
+    if(TANK_MARCH)
+        target_compile_options(${target} PRIVATE $<$<CONFIG:Release>:-march=${TANK_MARCH}>)
+    endif()
+    if(TANK_LTO AND TANK_IPO_SUPPORTED)
+        set_property(TARGET ${target} PROPERTY INTERPROCEDURAL_OPTIMIZATION_RELEASE TRUE)
+    endif()
+
+    if(TANK_PGO STREQUAL "GENERATE")
+        target_compile_options(${target} PRIVATE -fprofile-generate=${TANK_PGO_DIR})
+        target_link_libraries(${target} -fprofile-generate=${TANK_PGO_DIR})
+    elseif(TANK_PGO STREQUAL "USE")
+        if(NOT EXISTS ${TANK_PGO_DIR})
+            message(WARNING "TANK_PGO=USE but ${TANK_PGO_DIR} does not exist; run pgo-train first")
+        endif()
+        target_compile_options(${target} PRIVATE ${TANK_PGO_USE_FLAGS})
+    endif()
+endfunction()
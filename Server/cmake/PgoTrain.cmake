@@ -0,0 +1,35 @@
+# PGO training run, invoked by the pgo-train target as
+#   cmake -DSERVER=... -DBENCH=... -DSESSIONS=... -DPGO_DIR=... [-DPROFDATA=...] -P PgoTrain.cmake
+#
+# Replays every recorded session (*.rep) in SESSIONS, then runs the
+# synthetic SimulationBench profiles, so both the real input mix and the
+# heavy-load paths are in the profile.
+
+file(GLOB sessions "${SESSIONS}/*.rep")
+foreach(session ${sessions})
+    message(STATUS "PGO training: replay ${session}")
+    execute_process(COMMAND "${SERVER}" "--replay=${session}" RESULT_VARIABLE result)
+    if(NOT result EQUAL 0)
+        message(FATAL_ERROR "Replay of ${session} failed (${result})")
+    endif()
+endforeach()
+if(NOT sessions)
+    message(STATUS "PGO training: no recorded sessions in ${SESSIONS}; synthetic load only")
+endif()
+
+message(STATUS "PGO training: SimulationBench profiles")
+execute_process(COMMAND "${BENCH}" 3600 RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "SimulationBench failed (${result})")
+endif()
+
+if(PROFDATA)
+    file(GLOB raw "${PGO_DIR}/*.profraw")
+    execute_process(COMMAND "${PROFDATA}" merge -output=${PGO_DIR}/default.profdata ${raw}
+            RESULT_VARIABLE result)
+    if(NOT result EQUAL 0)
+        message(FATAL_ERROR "llvm-profdata merge failed (${result})")
+    endif()
+endif()
+
+message(STATUS "PGO training done; reconfigure with -DTANK_PGO=USE and rebuild")
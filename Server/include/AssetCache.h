@@ -0,0 +1,41 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Process-wide cache for textures and fonts.
+ * Each file is loaded from disk once and then handed out as an immutable
+ * shared handle, so entities can be created without touching the disk.
+ */
+class AssetCache {
+public:
+    static std::shared_ptr<const sf::Texture> getTexture(const std::string& path);
+    static std::shared_ptr<const sf::Font> getFont(const std::string& path);
+
+    // Optional: load everything up front so later lookups are just a map hit
+    static void preload(const std::vector<std::string>& texturePaths,
+                        const std::vector<std::string>& fontPaths);
+
+    // Per-asset load time and approximate memory footprint
+    static void reportStats(std::ostream& out);
+
+private:
+    struct AssetInfo {
+        double loadMs;
+        size_t bytes;
+        bool loaded;
+    };
+
+    static void recordLoad(const std::string& path, double loadMs, size_t bytes, bool loaded);
+
+    static std::mutex mtx;
+    static std::unordered_map<std::string, std::shared_ptr<const sf::Texture>> textures;
+    static std::unordered_map<std::string, std::shared_ptr<const sf::Font>> fonts;
+    static std::vector<std::pair<std::string, AssetInfo>> loadLog;
+};
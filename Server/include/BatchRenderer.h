@@ -0,0 +1,43 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include "Direction.h"
+
+/**
+ * Draws every projectile, enemy and spawn indicator with a single
+ * vertex-array draw call per frame.
+ * All of them sample one atlas texture (enemy sprite + a white disc that is
+ * tinted per vertex), so the call count does not grow with entity count.
+ */
+class BatchRenderer {
+public:
+    BatchRenderer();
+
+    // Start a new frame (keeps vertex capacity)
+    void begin();
+
+    void addProjectile(float x, float y, bool isEnemy);
+    void addSpawnIndicator(float x, float y);
+    void addEnemy(float x, float y, Direction dir);
+
+    // Issue the draw call for everything added since begin()
+    void flush(sf::RenderTarget& target);
+
+    size_t quadCount() const { return vertices.getVertexCount() / 4; }
+
+    // On-screen scale of enemy.png (shared with the legacy sprite path)
+    static constexpr float ENEMY_SPRITE_SCALE = 0.15f;
+
+private:
+    void addQuad(float cx, float cy, float halfW, float halfH, int rotationSteps,
+                 const sf::FloatRect& texRect, const sf::Color& color);
+
+    sf::Texture atlas;
+    sf::FloatRect enemyRect;
+    sf::FloatRect discRect;
+    sf::VertexArray vertices;
+
+    static constexpr float DISC_RADIUS = 32.0f;
+    static constexpr float PROJECTILE_RADIUS = 5.0f;
+    static constexpr float ATLAS_PADDING = 2.0f;
+};
@@ -1,15 +1,15 @@
 #pragma once
-#include <SFML/Graphics.hpp>
+#include "Vec2.h"
 #include "Direction.h"
+#include <cstdint>
 
 class Enemy {
 public:
-    // Constructor - initializes enemy at a specific position
-    Enemy(float x, float y);
+    // Constructor - initializes enemy at a specific position, facing dir
+    Enemy(float x, float y, Direction dir, std::uint32_t id);
 
-    // Called every frame to update timers and internal state
+    // Called every simulation tick to update timers and internal state
     void update(float dt);
-    void draw(sf::RenderWindow& window) const;
 
     // State checks
     bool isActive() const;
@@ -19,20 +19,18 @@ public:
     void hit();
 
     // Basic getters for gameplay logic (e.g., collisions, AI)
-    sf::Vector2f getPosition() const;
+    Vec2 getPosition() const;
     static float getRadius() ;
     Direction getDirection() const;
+    std::uint32_t getId() const { return id; }
 
     // Shooting behavior
     bool canShoot() const;
     void resetShootTimer();
 
 private:
-    // Visual representation
-    sf::Vector2f position;
-    sf::Texture texture;
-    sf::Sprite sprite;
-    sf::CircleShape spawnIndicator;
+    Vec2 position;
+    std::uint32_t id;
 
     // Internal state
     float spawnTimer;
@@ -43,4 +41,4 @@ private:
     static constexpr float SPAWN_TIME = 3.0f;
     static constexpr float RADIUS = 20.0f;
     static constexpr float SHOOT_COOLDOWN = 3.0f;
-};
\ No newline at end of file
+};
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "Enemy.h"
+#include <cstdint>
+#include <vector>
+
+// Enemies stored by value in one contiguous array, in spawn order. Storage
+// is reused, so once the largest wave so far has been seen, spawning and
+// removing enemies allocates nothing. Enemies are referred to across ticks
+// by their stable id, never by position.
+class EnemyPool {
+public:
+    Enemy& spawn(float x, float y, Direction dir, std::uint32_t id);
+    void clear() { enemies.clear(); }
+
+    // Remove every enemy matching pred, keeping the others in order
+    template<typename Pred>
+    int removeIf(Pred pred);
+
+    int size() const { return static_cast<int>(enemies.size()); }
+    bool empty() const { return enemies.empty(); }
+    Enemy& operator[](int i) { return enemies[i]; }
+    const Enemy& operator[](int i) const { return enemies[i]; }
+
+    std::vector<Enemy>::iterator begin() { return enemies.begin(); }
+    std::vector<Enemy>::iterator end() { return enemies.end(); }
+    std::vector<Enemy>::const_iterator begin() const { return enemies.begin(); }
+    std::vector<Enemy>::const_iterator end() const { return enemies.end(); }
+
+private:
+    std::vector<Enemy> enemies;
+};
+
+template<typename Pred>
+int EnemyPool::removeIf(Pred pred) {
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < enemies.size(); ++i) {
+        if (pred(enemies[i])) continue;
+        if (kept != i) {
+            enemies[kept] = enemies[i];
+        }
+        ++kept;
+    }
+    int removed = static_cast<int>(enemies.size() - kept);
+    // Enemy has no default constructor, so shrink by popping, not resize()
+    while (enemies.size() > kept) {
+        enemies.pop_back();
+    }
+    return removed;
+}
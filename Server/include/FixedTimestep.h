@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * Fixed-timestep scheduler.
+ * Wall-clock time is fed into an accumulator and paid out in whole ticks of
+ * 1 / tickRate seconds, so simulation speed does not depend on how long a
+ * loop iteration took. If the host falls too far behind, at most
+ * maxCatchUpTicks are run per advance() and the rest of the backlog is
+ * dropped instead of spiralling.
+ */
+class FixedTimestep {
+public:
+    explicit FixedTimestep(double tickRateHz, int maxCatchUpTicks = 8);
+
+    // Add elapsed wall time; returns how many ticks to simulate now
+    int advance(double elapsedSeconds);
+
+    // Seconds per tick
+    float dt() const { return static_cast<float>(tickSeconds); }
+    double tickRate() const { return 1.0 / tickSeconds; }
+
+    // Wall time until the next tick is due
+    double timeUntilNextTick() const { return tickSeconds - accumulator; }
+
+    // Ticks skipped because of the catch-up limit
+    std::uint64_t droppedTicks() const { return dropped; }
+
+private:
+    double tickSeconds;
+    double accumulator;
+    int maxCatchUp;
+    std::uint64_t dropped;
+};
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "Direction.h"
+#include "Tank.h"
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+// Everything the renderer needs to draw one simulation tick.
+// Filled by GameState::writeSnapshot() and read-only once published.
+// Moving things carry their position from the previous tick too, so the
+// renderer can interpolate between the last two states.
+struct FrameSnapshot {
+    struct ProjectileView {
+        float x, y;
+        float prevX, prevY;
+        bool isEnemy;
+        std::uint32_t id;
+    };
+
+    struct EnemyView {
+        float x, y;
+        Direction direction;
+        bool spawning;
+        bool active;
+        std::uint32_t id;
+    };
+
+    // Simulation tick this was taken on, when it was published and the
+    // tick length (set by the publisher)
+    std::uint64_t tick = 0;
+    std::chrono::steady_clock::time_point publishedAt{};
+    float tickSeconds = 1.0f / 60.0f;
+
+    Tank tank{};
+    float tankPrevX = 0.0f;
+    float tankPrevY = 0.0f;
+    Direction tankDirection = Direction::RIGHT;
+    float turretAngle = 0.0f;
+    float tankHitEffect = 0.0f;
+    bool playerAlive = true;
+    int wave = 0;
+
+    std::vector<ProjectileView> projectiles;
+    std::vector<EnemyView> enemies;
+};
@@ -1,46 +1,70 @@
 #pragma once
 
 #include <SFML/Graphics.hpp>
-#include "GameState.h"
+#include "SnapshotBuffer.h"
 #include "Direction.h"
+#include "BatchRenderer.h"
 #include <atomic>
+#include <memory>
 
 // Responsible for rendering the game window and visual elements
 class GameRender {
 public:
-    GameRender();
+    // batched selects BatchRenderer; F1 toggles it at runtime for comparison
+    explicit GameRender(bool batchedRender = true);
     ~GameRender();
 
-    // Main rendering loop - draws everything to the screen
-    void run(GameState& state, Direction& currentDir, std::atomic<bool>& running);
+    // Main rendering loop - draws the newest published snapshot each frame.
+    // Never touches GameState, so it takes no simulation lock.
+    void run(SnapshotBuffer& snapshots, std::atomic<bool>& running);
 
 private:
+    // Per-entity draw calls (the original path); alpha blends prev -> current tick.
+    // Both return the number of entity quads drawn.
+    size_t drawEntitiesLegacy(const FrameSnapshot& snap, float alpha);
+    // One vertex-array draw call for all entities
+    size_t drawEntitiesBatched(const FrameSnapshot& snap, float alpha);
+    void recordFrameTime(float ms, size_t quads);
+
     // Window and background rendering
     sf::RenderWindow window;
     sf::Texture backgroundTexture;
     sf::Sprite backgroundSprite;
 
     // Tank rendering
-    sf::Texture bodyTexture;
-    sf::Texture turretTexture;
+    std::shared_ptr<const sf::Texture> bodyTexture;
+    std::shared_ptr<const sf::Texture> turretTexture;
     sf::Sprite bodySprite;
     sf::Sprite turretSprite;
 
     // Projectile visuals
     sf::CircleShape projectileShape;
 
-    // Time tracking for animations and updates
-    sf::Clock deltaClock;
+    // Enemy visuals for the legacy path
+    std::shared_ptr<const sf::Texture> enemyTexture;
+    sf::Sprite enemySprite;
+    sf::CircleShape spawnIndicator;
+
+    // Batched entity path
+    BatchRenderer batchRenderer;
+    bool batched;
+
+    // Frame-time and quad-count averages, printed per render path
+    float frameTimeAccumMs = 0.0f;
+    size_t quadAccum = 0;
+    int frameTimeSamples = 0;
+    static constexpr int FRAME_TIME_WINDOW = 300;
 
     // Visual effect for when the tank gets hit
     sf::RectangleShape hitEffect;
 
+    // Shared UI font
+    std::shared_ptr<const sf::Font> uiFont;
+
     // Game Over UI
-    sf::Font gameOverFont;
     sf::Text gameOverText;
     sf::RectangleShape overlay;
 
     // Wave number UI
     sf::Text waveText;
-    sf::Font waveFont;
 };
\ No newline at end of file
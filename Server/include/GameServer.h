@@ -1,46 +1,146 @@
 #pragma once
 
 #include "Direction.h"
+#include "InputRing.h"
+#include "TickInput.h"
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <netinet/in.h>
 #include <atomic>
+#include <deque>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 
-// Forward declaration to avoid circular include
-class GameState;
-
+// Non-blocking TCP server driven by one epoll thread. Any number of clients
+// may connect; the first GameState::PLAYER_SLOTS of them control a tank and
+// the rest are spectators that only receive messages. Players may also send
+// input over UDP on the same port, tagged with the token they got over TCP.
 class GameServer {
 public:
     explicit GameServer(int port);
     ~GameServer();
 
-    // Start and stop functions for server
+    // Start and stop functions for server. start() launches the network
+    // thread and returns immediately; stop() is safe from a signal handler.
     void start();
     void stop();
 
-    [[nodiscard]] Direction getCurrentDirection() const;
-    int getTurretRotationDelta();
-    bool getButtonPressed();
+    // Simulation thread: consume the slot's input events received up to
+    // deadline. Rotation is summed; at most one fire per tick, so a second
+    // press waits for the next tick instead of being merged.
+    TickInput sampleInput(int slot, std::chrono::steady_clock::time_point deadline);
+
+    // Queued for every client and written by the network thread after the
+    // next flush(). Health is only sent when it changes.
+    void sendTankHealth(int health);
+    void sendGameOver(const char* message);
+    void sendHitMessage();
+
+    // State stream for subscribed clients (see StateStream.h). A client
+    // that joined or fell behind waits for the next keyframe.
+    bool hasStateSubscribers() const { return stateSubscribers > 0; }
+    bool takeKeyframeRequest() { return keyframeRequested.exchange(false); }
+    void sendState(const std::string& frame, bool isKeyframe);
 
-    void sendTankHealth(int health) const;
-    void sendGameOver(const char* message) const;
-    void sendHitMessage() const;
+    // Hand everything queued this tick to the network thread in one go
+    void flush();
 
-    // Link to the GameState to allow invoking actions like cheats
-    void setGameState(GameState* gs);
+    int getClientCount() const { return clientCount; }
 
 private:
-    void receiveInput();
-    void processInputToken(const std::string& token);
+    static constexpr int MAX_PLAYER_SLOTS = 8;
+    static constexpr size_t MAX_READ_BUFFER = 1024;
+    // Outbound backpressure per client: past the soft limit state frames are
+    // skipped (resync by keyframe later); past the hard limit it is closed
+    static constexpr size_t SOFT_WRITE_LIMIT = 64 * 1024;
+    static constexpr size_t HARD_WRITE_LIMIT = 256 * 1024;
+    static constexpr int MAX_IOVECS = 16;
+
+    // Chosen from the first byte a client sends
+    enum class Protocol { UNKNOWN, TEXT, BINARY };
+
+    struct Connection {
+        int fd = -1;
+        int slot = -1;          // -1 = spectator
+        Protocol protocol = Protocol::UNKNOWN;
+        std::uint16_t lastSeq = 0;
+        bool haveSeq = false;
+        std::uint32_t udpToken = 0;
+        std::uint16_t udpLastSeq = 0;
+        bool haveUdpSeq = false;
+        bool subscribed = false;
+        bool needsKeyframe = false;  // guarded by writeMutex
+        std::string readBuf;
+        bool wantWrite = false; // EPOLLOUT registered
+
+        // Guarded by writeMutex: this tick's messages, everything not yet
+        // written, and whether the client blew the hard limit
+        std::string pending;
+        size_t queuedBytes = 0;
+        bool overflowed = false;
+
+        // Network thread only: whole batches waiting for the socket, and a
+        // recycled buffer that becomes the next pending batch
+        std::deque<std::string> outQueue;
+        size_t outOffset = 0;
+        std::string spare;
+    };
+
+    void networkLoop();
+    void acceptClients();
+    void readClient(Connection& conn);
+    void readDatagrams();
+    bool flushClient(Connection& conn);
+    void flushAll();
+    void closeClient(int fd);
+    void closeAll();
+    bool processBinaryFrames(Connection& conn, size_t& consumed);
+    bool processTextMessages(Connection& conn, size_t& consumed);
+    void processMessage(Connection& conn, std::string_view message);
+    void applyInput(int slot, Direction direction, int rotation, bool fire);
+    void requestCheat(Connection& conn);
+    void subscribe(Connection& conn);
+    void broadcast(const char* message, size_t len);
+    void queueForAll(const char* message, size_t len);
+    void updateWriteInterest(Connection& conn);
+    void wakeNetworkThread();
     void registerServerCleanup();
 
     int server_fd;
-    int client_fd;
+    int udp_fd;
+    int epoll_fd;
+    int wake_fd;
     sockaddr_in server_addr;
-    sockaddr_in client_addr;
-    socklen_t addr_len;
 
-    std::atomic<Direction> currentDirection;
-    std::atomic<int> turretRotationDelta;
-    std::atomic<bool> buttonPressed;
-    GameState* gameState = nullptr;
+    std::thread networkThread;
+    std::atomic<bool> running{false};
+
+    // Owned by the network thread. writeMutex guards inserting/erasing
+    // entries and the pending side of every connection's queue.
+    std::unordered_map<int, Connection> connections;
+    std::mutex writeMutex;
+    std::atomic<int> clientCount{0};
+    std::atomic<int> stateSubscribers{0};
+    std::atomic<bool> keyframeRequested{false};
+    // Guarded by writeMutex, so a new client either gets the HP broadcast
+    // or already has the value in its greeting
+    static constexpr int NO_HEALTH = -1000;
+    int lastHealth = NO_HEALTH;
+
+    // UDP token -> TCP fd, network thread only
+    std::unordered_map<std::uint32_t, int> udpTokens;
+    std::mt19937 tokenRng{std::random_device{}()};
+    std::uint64_t staleDatagramFrames = 0;
+    std::atomic<std::uint64_t> droppedStateFrames{0};
+    std::uint64_t slowClientsClosed = 0;
+    std::vector<int> closing;  // scratch for flushAll()
+
+    // Network thread pushes, simulation thread drains (and owns heldDirection)
+    InputRing inputs[MAX_PLAYER_SLOTS];
+    Direction heldDirection[MAX_PLAYER_SLOTS];
+    int slotOwner[MAX_PLAYER_SLOTS];
 };
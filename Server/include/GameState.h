@@ -2,28 +2,38 @@
 
 #include "Direction.h"
 #include "Tank.h"
-#include "Enemy.h"
+#include "EnemyPool.h"
+#include "SpatialGrid.h"
+#include "ProjectilePool.h"
+#include "FrameSnapshot.h"
+#include "TickInput.h"
 #include <vector>
 #include <cmath>
-#include <memory>
 #include <random>
-#include <mutex>
+#include <cstdint>
 
 class GameServer;
 
-struct Projectile {
-    float x, y;
-    float angle;
-    float speed;
-    bool isEnemyProjectile;
-};
-
+// Owned by the simulation thread, which is the only one that calls into
+// it, so nothing here locks. Other threads never touch it directly: the
+// network thread queues input and cheats on GameServer's lock-free
+// InputRing, drained at the start of each tick into a TickInput, and the
+// renderer and state stream read copies written by writeSnapshot().
 class GameState {
 public:
-    GameState();
+    // Controller connections that can drive a tank; the simulation has one.
+    // Further connections are spectators (they still get HP/HIT/GAME_OVER).
+    static constexpr int PLAYER_SLOTS = 1;
+
+    // Everything random is drawn from seed, so a seed plus the per-tick
+    // input reproduces a session exactly (see Replay.h)
+    explicit GameState(std::uint32_t seed);
+
+    // Run one simulation tick of dt seconds with the given player input
+    void step(const TickInput& input, float dt);
 
     // Movement and rotation
-    void updateTankPosition(Direction dir);
+    void updateTankPosition(Direction dir, float dt);
     void updateTurretRotation(int delta);
 
     // Firing methods
@@ -31,23 +41,31 @@ public:
     void enemyFireProjectile(float x, float y, float angle);
 
     // Updates called every frame
-    void updateProjectiles();
+    void updateEnemies(float dt);
+    void updateEnemyFire();
+    void updateProjectiles(float dt);
     void spawnEnemies();
+    // Replace the current enemies with a fresh wave (benchmarks, testing)
+    void startWave(int wave);
     void checkProjectileCollisions();
     void checkTankHit();
 
     // Getters
     const Tank &getTank() const;
     float getTurretAngle() const;
-    const std::vector<Projectile>& getProjectiles() const;
-    const std::vector<std::unique_ptr<Enemy>>& getEnemies() const;
+    const ProjectilePool& getProjectiles() const;
+    const EnemyPool& getEnemies() const;
     bool isPlayerAlive() const;
 
     float getTankHitEffect() const;
+    Direction getTankDirection() const;
     int getCurrentWave() const { return currentWave; }
 
-    // Expose internal mutex for thread safety
-    std::recursive_mutex& getMutex() { return mtx; }
+    // Copy the drawable state into a snapshot slot (reuses its capacity)
+    void writeSnapshot(FrameSnapshot& out) const;
+
+    // Hash of the simulation state, for checking that a replay did not diverge
+    std::uint64_t checksum() const;
 
     // Link to server for feedback (e.g., hit messages)
     void setServer(GameServer* srv);
@@ -56,28 +74,47 @@ public:
 
 
 private:
+    // Broadphase over projectiles, shared by both collision passes
+    void rebuildProjectileGrid();
+    void removeHitProjectiles();
+
     Tank tank;
+    float tankPrevX;
+    float tankPrevY;
+    Direction tankDirection;
     float turretAngle;
 
-    std::vector<Projectile> projectiles;
-    std::vector<std::unique_ptr<Enemy>> enemies;
+    ProjectilePool projectiles;
+    EnemyPool enemies;
+
+    SpatialGrid projectileGrid;
+    bool projectileGridDirty;
+    std::vector<char> projectileHit;
 
     // Enemy number and location
     std::mt19937 rng;
     std::uniform_real_distribution<float> xDist;
     std::uniform_real_distribution<float> yDist;
 
-    mutable std::recursive_mutex mtx;
     float enemyShootTimer;
     float tankHitEffectTimer;
+    float lastTickSeconds;
 
     bool playerAlive;
     static constexpr float ENEMY_SHOOT_INTERVAL = 3.0f;
     static constexpr float HIT_EFFECT_DURATION = 0.5f;
+    static constexpr float TANK_HIT_RADIUS = 20.0f;
+    static constexpr float GRID_CELL_SIZE = 64.0f;
+
+    // Speeds in pixels per second (formerly per 60 Hz frame: 10, 15, 10)
+    static constexpr float TANK_SPEED = 600.0f;
+    static constexpr float PLAYER_PROJECTILE_SPEED = 900.0f;
+    static constexpr float ENEMY_PROJECTILE_SPEED = 600.0f;
 
 
     int currentWave;
     int enemiesKilledThisWave;
+    std::uint32_t nextEnemyId = 1;
     static constexpr int WAVES_FOR_ENEMY_INCREASE = 5;
 
     GameServer *server = nullptr;
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "Direction.h"
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Binary controller input protocol (client -> server).
+ *
+ * Every frame is a 4-byte header followed by `length` payload bytes:
+ *
+ *   u8 magic (0xA5)  u8 version  u8 type  u8 length  payload...
+ *
+ * Multi-byte fields are big-endian. The magic byte can never start a text
+ * message, so the server picks the protocol from a connection's first byte
+ * and the comma-separated text format keeps working as a fallback.
+ *
+ *   INPUT (6 bytes): u16 seq, u8 direction, i16 rotation, u8 flags (bit 0 = fire)
+ *   CHEAT (2 bytes): u16 seq
+ *   SUBSCRIBE (2 bytes): u16 seq; start receiving the StateStream
+ *   INPUT_BUNDLE (5 + 6n bytes, UDP only): u32 token, u8 n, then n INPUT
+ *       payloads, newest first. Each datagram repeats the last few inputs so
+ *       a lost packet is covered by the next one; token ties it to a TCP
+ *       connection (sent to the client as "UDP:<token>\n").
+ *
+ * Frames of an unknown type are skipped using their length, so newer
+ * clients can add types without breaking older servers.
+ */
+namespace InputProtocol {
+    constexpr std::uint8_t MAGIC = 0xA5;
+    constexpr std::uint8_t VERSION = 1;
+    constexpr std::size_t HEADER_SIZE = 4;
+
+    enum class FrameType : std::uint8_t {
+        INPUT = 1,
+        CHEAT = 2,
+        INPUT_BUNDLE = 3,
+        SUBSCRIBE = 4
+    };
+
+    // Most INPUT payloads one bundle may carry
+    constexpr int MAX_BUNDLE_FRAMES = 8;
+
+    constexpr std::uint8_t FLAG_FIRE = 0x01;
+
+    struct Frame {
+        FrameType type;
+        std::uint16_t seq;
+        Direction direction;
+        std::int16_t rotation;
+        bool fire;
+    };
+
+    enum class ParseResult {
+        FRAME,      // out is filled in
+        SKIPPED,    // well-formed frame of a type this server ignores
+        NEED_MORE,  // incomplete; wait for more bytes
+        INVALID     // bad magic or version; the stream cannot be resynced
+    };
+
+    // Parse one frame from the front of data without allocating.
+    // consumed is set for FRAME and SKIPPED.
+    ParseResult parse(const char* data, std::size_t len, Frame& out, std::size_t& consumed);
+
+    struct Bundle {
+        std::uint32_t token;
+        int count;
+        Frame frames[MAX_BUNDLE_FRAMES];  // newest first
+    };
+
+    // Parse one whole datagram as an INPUT_BUNDLE; false if malformed
+    bool parseBundle(const char* data, std::size_t len, Bundle& out);
+
+    // True if seq is newer than last in 16-bit serial-number arithmetic
+    inline bool isNewer(std::uint16_t seq, std::uint16_t last) {
+        return static_cast<std::int16_t>(static_cast<std::uint16_t>(seq - last)) > 0;
+    }
+}
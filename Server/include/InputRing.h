@@ -0,0 +1,47 @@
+#pragma once
+
+#include "Direction.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// One input message from a controller, stamped when the server read it
+struct InputEvent {
+    std::chrono::steady_clock::time_point receivedAt;
+    Direction direction;
+    int rotation;
+    bool fire;
+    // Cheat request; carries no movement, so the held direction is kept
+    bool cheat;
+};
+
+/**
+ * Lock-free single-producer/single-consumer ring of InputEvents.
+ * The network thread pushes every input it receives and the simulation
+ * drains them per tick, so presses and rotation steps that arrive between
+ * two ticks are neither merged nor lost. A full ring drops the new event
+ * and counts it rather than blocking the network thread.
+ */
+class InputRing {
+public:
+    static constexpr std::uint32_t CAPACITY = 1024;  // power of two
+
+    // Producer side
+    bool push(const InputEvent& event);
+
+    // Consumer side: oldest event or nullptr, then pop() to consume it
+    const InputEvent* peek() const;
+    void pop();
+
+    std::uint64_t dropped() const { return droppedCount.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr std::uint32_t MASK = CAPACITY - 1;
+
+    InputEvent events[CAPACITY];
+
+    // Separate cache lines so producer and consumer do not false-share
+    alignas(64) std::atomic<std::uint32_t> head{0};   // next to write
+    alignas(64) std::atomic<std::uint32_t> tail{0};   // next to read
+    std::atomic<std::uint64_t> droppedCount{0};
+};
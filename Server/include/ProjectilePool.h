@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// Structure-of-arrays projectile store. Velocities are resolved from the
+// firing angle once at spawn time, and integrate() runs over fixed-width
+// blocks so the compiler can vectorize it. Removal is swap-and-pop, so an
+// index is only valid until the next integrate() or remove().
+class ProjectilePool {
+public:
+    // angle is in degrees, 0 = up, clockwise; speed is in pixels per second
+    void spawn(float x, float y, float angle, float speed, bool isEnemy);
+    void remove(int i);
+    void clear();
+
+    // Advance every projectile by dt seconds and drop those outside [0,w]x[0,h]
+    void integrate(float dt, float width, float height);
+
+    int size() const { return count; }
+    float x(int i) const { return posX[i]; }
+    float y(int i) const { return posY[i]; }
+    float velocityX(int i) const { return velX[i]; }
+    float velocityY(int i) const { return velY[i]; }
+    bool isEnemy(int i) const { return enemy[i] != 0; }
+    // Stable for the projectile's lifetime, unlike its index
+    std::uint32_t id(int i) const { return ids[i]; }
+
+    // Arrays are padded to a multiple of this so the kernel needs no scalar tail
+    static constexpr int LANES = 8;
+
+private:
+    int count = 0;
+    std::uint32_t nextId = 1;
+
+    std::vector<float> posX;
+    std::vector<float> posY;
+    std::vector<float> velX;
+    std::vector<float> velY;
+    std::vector<std::uint8_t> enemy;
+    std::vector<std::uint32_t> ids;
+    std::vector<std::int32_t> outOfBounds;
+};
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "TickInput.h"
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+/**
+ * Recorded sessions: the simulation seed plus the input of every tick.
+ * GameState is deterministic given both, so a replay re-simulates the
+ * session exactly, as fast as the machine allows.
+ *
+ * File layout (multi-byte fields big-endian):
+ *
+ *   "TKRP"  u8 version  u32 seed  u64 tickRate (IEEE double bits)
+ *   records...
+ *   u8 END  u64 ticks  u64 checksum
+ *
+ * Each record starts with one byte: bits 0-2 direction, then flags.
+ *   ROTATION  a zigzag varint rotation delta follows
+ *   FIRE      fire this tick
+ *   CHEAT     restore tank health this tick
+ *   RUN       a varint count follows; that many ticks hold the direction
+ *             with no other input (idle stretches cost two or three bytes)
+ *
+ * The trailer holds GameState::checksum() after the last tick so playback
+ * can tell whether it diverged. A file cut short (crash, kill -9) still
+ * plays back; it just cannot be verified.
+ */
+namespace Replay {
+
+constexpr std::uint8_t VERSION = 1;
+
+enum RecordFlag : std::uint8_t {
+    DIRECTION_MASK = 0x07,
+    ROTATION = 0x08,
+    FIRE = 0x10,
+    CHEAT = 0x20,
+    RUN = 0x40,
+    END = 0x80
+};
+
+class Writer {
+public:
+    ~Writer();
+
+    bool open(const std::string& path, std::uint32_t seed, double tickRate);
+    bool isOpen() const { return out.is_open(); }
+
+    void record(const TickInput& input);
+
+    // Write the trailer and close; called once the last tick has run
+    void finish(std::uint64_t ticks, std::uint64_t checksum);
+
+private:
+    void flushRun();
+    void putVarint(std::uint64_t v);
+
+    std::ofstream out;
+    // Idle ticks are held back and written as one RUN record
+    Direction runDirection = Direction::NONE;
+    std::uint64_t runLength = 0;
+};
+
+class Reader {
+public:
+    bool open(const std::string& path);
+
+    std::uint32_t seed() const { return fileSeed; }
+    double tickRate() const { return fileTickRate; }
+
+    // Input for the next tick; false at the end of the recording
+    bool next(TickInput& input);
+
+    // Valid once next() has returned false
+    bool hasTrailer() const { return trailer; }
+    std::uint64_t recordedTicks() const { return trailerTicks; }
+    std::uint64_t recordedChecksum() const { return trailerChecksum; }
+
+private:
+    bool getVarint(std::uint64_t& v);
+
+    std::ifstream in;
+    std::uint32_t fileSeed = 0;
+    double fileTickRate = 0.0;
+
+    Direction runDirection = Direction::NONE;
+    std::uint64_t runRemaining = 0;
+
+    bool trailer = false;
+    std::uint64_t trailerTicks = 0;
+    std::uint64_t trailerChecksum = 0;
+};
+
+} // namespace Replay
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// Runtime options for the server, set from the command line
+struct ServerConfig {
+    int port = 8080;
+
+    // Draw entities through BatchRenderer; false uses one draw call per entity
+    bool batchedRender = true;
+
+    // Simulation rate in Hz and how many ticks one loop may run to catch up
+    double tickRate = 60.0;
+    int maxCatchUpTicks = 8;
+
+    // No window or textures; always true in a TANK_HEADLESS build
+    bool headless = false;
+    // Run ticks back to back instead of pacing them to wall time
+    bool unthrottled = false;
+    // Stop after this many ticks (0 = run until shutdown)
+    std::uint64_t maxTicks = 0;
+
+    // Simulation seed (0 = pick one at random)
+    std::uint32_t seed = 0;
+    // Record the session to this file (see Replay.h)
+    std::string recordPath;
+    // Re-simulate a recorded session headless and exit; no network
+    std::string replayPath;
+
+    // Rewrite this file with telemetry as JSON every telemetryInterval seconds
+    std::string telemetryPath;
+    double telemetryInterval = 1.0;
+
+    // Chrome trace output at exit; needs a -DTANK_TRACE=ON build
+    std::string tracePath;
+};
+
+// Parses argv; prints usage and exits on --help or an unknown flag
+ServerConfig parseServerConfig(int argc, char* argv[]);
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "FrameSnapshot.h"
+#include <atomic>
+#include <cstdint>
+
+/**
+ * Lock-free triple buffer of FrameSnapshots between one writer (simulation)
+ * and one reader (renderer).
+ * The writer fills its private slot and publishes it with one atomic
+ * exchange; the reader swaps in the newest published slot when there is one.
+ * Neither side ever waits on the other, and slots (with their vector
+ * capacity) are recycled, so steady-state publishing does not allocate.
+ */
+class SnapshotBuffer {
+public:
+    SnapshotBuffer();
+
+    // Writer side: the slot to fill, then publish() to hand it over
+    FrameSnapshot& beginWrite();
+    void publish();
+
+    // Reader side: newest published snapshot, valid until the next acquire()
+    const FrameSnapshot& acquire();
+
+private:
+    static constexpr std::uint8_t INDEX_MASK = 0x3;
+    static constexpr std::uint8_t FRESH = 0x4;
+
+    FrameSnapshot slots[3];
+
+    // Index of the slot between writer and reader, plus FRESH if unread
+    std::atomic<std::uint8_t> middle;
+    std::uint8_t writeIndex;
+    std::uint8_t readIndex;
+};
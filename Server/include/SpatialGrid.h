@@ -0,0 +1,71 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+
+// Uniform-grid broadphase for point entities (projectiles) in the arena.
+// Points are staged with insert() and bucketed with a counting sort in
+// build(), so each cell's entries end up contiguous in memory. Rebuild it
+// once per tick after entities have moved.
+class SpatialGrid {
+public:
+    SpatialGrid(float width, float height, float cellSize);
+
+    // Drop all staged and built entries (keeps capacity).
+    void clear();
+
+    // Stage a point; it becomes visible to queries after build().
+    void insert(int id, float x, float y);
+
+    // Sort the staged points into their cells.
+    void build();
+
+    // Calls fn(id) for every point strictly within radius of (x, y).
+    // Uses squared distances only.
+    template<typename Fn>
+    void query(float x, float y, float radius, Fn &&fn) const {
+        int minCol = cellCoord(x - radius, cols);
+        int maxCol = cellCoord(x + radius, cols);
+        int minRow = cellCoord(y - radius, rows);
+        int maxRow = cellCoord(y + radius, rows);
+        float radiusSq = radius * radius;
+
+        for (int row = minRow; row <= maxRow; ++row) {
+            for (int col = minCol; col <= maxCol; ++col) {
+                int cell = row * cols + col;
+                for (int i = cellStart[cell]; i < cellStart[cell + 1]; ++i) {
+                    float dx = sortedX[i] - x;
+                    float dy = sortedY[i] - y;
+                    if (dx * dx + dy * dy < radiusSq) {
+                        fn(sortedIds[i]);
+                    }
+                }
+            }
+        }
+    }
+
+    int size() const { return static_cast<int>(sortedIds.size()); }
+
+private:
+    int cellCoord(float v, int limit) const {
+        int c = static_cast<int>(v * invCellSize);
+        return std::max(0, std::min(c, limit - 1));
+    }
+
+    int cols;
+    int rows;
+    float invCellSize;
+
+    // Staged input
+    std::vector<int> stagedIds;
+    std::vector<float> stagedX;
+    std::vector<float> stagedY;
+    std::vector<int> stagedCell;
+
+    // Cell-ordered output; cellStart has cols * rows + 1 entries
+    std::vector<int> cellStart;
+    std::vector<int> cellCursor;
+    std::vector<int> sortedIds;
+    std::vector<float> sortedX;
+    std::vector<float> sortedY;
+};
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "FrameSnapshot.h"
+#include <cstdint>
+#include <string>
+
+/**
+ * Server -> client state replication, for clients that subscribe.
+ *
+ * Each tick becomes one binary frame with a 7-byte header:
+ *
+ *   u8 magic (0xA6)  u8 version  u8 type  u32 length  payload...
+ *
+ * KEYFRAME carries the whole world; DELTA only what changed since the
+ * previous tick's frame. Multi-byte fields are big-endian, positions are
+ * 1/16 px (u16) and entities are keyed by a 16-bit id.
+ *
+ * Payload: u32 tick, u8 tankMask, then the tank fields named in the mask:
+ *   TANK_POS      u16 x, u16 y
+ *   TANK_TURRET   u16 angle (1/100 degree)
+ *   TANK_DIR      u8 direction
+ *   TANK_HEALTH   i8 health, u8 alive
+ *   WAVE          u16 wave
+ * Enemies:     u16 removed, removed x u16 id,
+ *              u16 upserted, upserted x (u16 id, u16 x, u16 y, u8 direction | state << 4)
+ * Projectiles: u16 removed, removed x u16 id,
+ *              u16 added, added x (u16 id, u16 x, u16 y, i16 vx, i16 vy, u8 isEnemy)
+ *
+ * Projectiles fly in a straight line, so after they are added only their
+ * removal is sent; clients extrapolate position from velocity (px/s).
+ * A keyframe has every tank bit set, no removals and every entity added.
+ */
+class StateStream {
+public:
+    static constexpr std::uint8_t MAGIC = 0xA6;
+    static constexpr std::uint8_t VERSION = 1;
+    static constexpr std::size_t HEADER_SIZE = 7;
+
+    enum FrameType : std::uint8_t {
+        KEYFRAME = 1,
+        DELTA = 2
+    };
+
+    enum TankField : std::uint8_t {
+        TANK_POS = 0x01,
+        TANK_TURRET = 0x02,
+        TANK_DIR = 0x04,
+        TANK_HEALTH = 0x08,
+        WAVE = 0x10,
+        ALL_FIELDS = 0x1F
+    };
+
+    // Enemy state nibble
+    enum EnemyState : std::uint8_t {
+        ENEMY_SPAWNING = 1,
+        ENEMY_ACTIVE = 2
+    };
+
+    explicit StateStream(int keyframeInterval = 120);
+
+    // Encode snap against the previous call; a keyframe when forced or due.
+    // Returns the frame, valid until the next call.
+    const std::string& encode(const FrameSnapshot& snap, bool forceKeyframe);
+
+    bool lastWasKeyframe() const { return keyframe; }
+
+private:
+    void writeTank(std::uint8_t mask);
+    void writeEnemies(bool full);
+    void writeProjectiles(bool full);
+
+    void putU8(std::uint8_t v) { frame.push_back(static_cast<char>(v)); }
+    void putU16(std::uint16_t v);
+    void putU32(std::uint32_t v);
+    void patchU16(std::size_t at, std::uint32_t v);
+    void putPos(float v);
+
+    int keyframeInterval;
+    int ticksSinceKeyframe;
+    bool keyframe = false;
+    bool havePrevious = false;
+
+    // Copies sorted by id, so deltas are a merge walk. Swapped each tick.
+    FrameSnapshot previous;
+    FrameSnapshot current;
+    std::string frame;
+};
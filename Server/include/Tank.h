@@ -1,8 +1,8 @@
 #pragma once
 
 struct Tank {
-    int x;
-    int y;
-    int speed;
+    float x;
+    float y;
+    float speed;   // pixels per second
     int health;
 };
\ No newline at end of file
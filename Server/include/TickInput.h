@@ -0,0 +1,12 @@
+#pragma once
+
+#include "Direction.h"
+
+// Player input applied by one simulation tick
+struct TickInput {
+    Direction direction = Direction::NONE;
+    int rotationDelta = 0;
+    bool fire = false;
+    // Cheat: refill the tank's health before this tick runs
+    bool restoreHealth = false;
+};
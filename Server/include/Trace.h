@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+/**
+ * Scoped profiling zones written as Chrome trace-event JSON (load in
+ * chrome://tracing or ui.perfetto.dev), one timeline per thread.
+ *
+ * Compiled in only with -DTANK_TRACE=ON; otherwise TRACE_ZONE expands to
+ * nothing and the functions below are empty inlines. Timestamps are wall
+ * clock microseconds, so a server trace and a client trace (pid 2, see
+ * Client/app/include/trace.h) can be merged and lined up:
+ *
+ *   jq -s '{traceEvents: (map(.traceEvents) | add)}' server.json client.json
+ *
+ * Each thread records into its own fixed-size ring (no locks after its
+ * first zone), so a long run keeps its newest zones and overwrites the oldest.
+ */
+
+#ifdef TANK_TRACE
+
+namespace Trace {
+
+class Zone {
+public:
+    explicit Zone(const char* name);
+    ~Zone();
+
+    Zone(const Zone&) = delete;
+    Zone& operator=(const Zone&) = delete;
+
+private:
+    const char* name;
+    std::uint64_t startUs;
+};
+
+// Label the calling thread's timeline
+void setThreadName(const char* name);
+
+// Where write() puts the trace; false if it cannot be created
+bool open(const std::string& path);
+// Write everything recorded so far; safe while other threads are recording
+void write();
+
+} // namespace Trace
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+// name must be a string literal (or otherwise outlive the trace)
+#define TRACE_ZONE(name) Trace::Zone TRACE_CONCAT(traceZone, __LINE__)(name)
+
+#else
+
+namespace Trace {
+
+inline void setThreadName(const char*) {}
+inline bool open(const std::string&) { return false; }
+inline void write() {}
+
+} // namespace Trace
+
+#define TRACE_ZONE(name) static_cast<void>(0)
+
+#endif
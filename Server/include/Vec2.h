@@ -0,0 +1,7 @@
+#pragma once
+
+// Plain 2D vector for simulation code, so it does not depend on SFML
+struct Vec2 {
+    float x;
+    float y;
+};
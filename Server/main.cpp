@@ -1,108 +1,198 @@
 #include "include/GameServer.h"
 #include "include/GameState.h"
-#include "include/GameRender.h"
 #include "include/Shutdown.h"
+#include "include/ServerConfig.h"
+#include "include/SnapshotBuffer.h"
+#include "include/FixedTimestep.h"
+#include "include/StateStream.h"
+#include "include/Replay.h"
+#include "include/Telemetry.h"
+#include "include/Trace.h"
 #include <chrono>
 #include <thread>
 #include <iostream>
-#include <mutex>
 #include <csignal>
 #include <atomic>
+#include <memory>
+#include <random>
+
+#ifndef TANK_HEADLESS
+#include "include/GameRender.h"
+#include "include/AssetCache.h"
+#endif
 
 // Signal handler for graceful shutdown
 void signalHandler(int) {
     ShutdownModule::requestShutdown();
 }
 
-int main() {
+// Re-simulate a recorded session headless, as fast as possible, and check
+// that it ends in the recorded state
+static int runReplay(const ServerConfig& config) {
+    Replay::Reader replay;
+    if (!replay.open(config.replayPath)) {
+        std::cerr << "Cannot read replay " << config.replayPath << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    GameState gameState(replay.seed());
+    // Same tick length the recording ran with
+    float dt = FixedTimestep(replay.tickRate()).dt();
+    std::uint64_t tick = 0;
+    TickInput input;
+
+    auto start = std::chrono::steady_clock::now();
+    while (!ShutdownModule::isShutdownRequested() && replay.next(input)) {
+        gameState.step(input, dt);
+        ++tick;
+        if (config.maxTicks > 0 && tick >= config.maxTicks) break;
+    }
+    double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double simSeconds = static_cast<double>(tick) / replay.tickRate();
+
+    std::cout << "Replayed " << tick << " ticks (" << simSeconds << " s, seed " << replay.seed() << ") in "
+              << wallSeconds << " s, " << (tick > 0 ? wallSeconds * 1e9 / static_cast<double>(tick) : 0.0)
+              << " ns/tick, " << (wallSeconds > 0.0 ? simSeconds / wallSeconds : 0.0) << "x real time"
+              << std::endl;
+
+    if (!replay.hasTrailer()) {
+        std::cout << "Recording has no trailer; result not verified" << std::endl;
+        return EXIT_SUCCESS;
+    }
+    if (tick != replay.recordedTicks()) {
+        std::cout << "Stopped after " << tick << " of " << replay.recordedTicks()
+                  << " recorded ticks; result not verified" << std::endl;
+        return EXIT_SUCCESS;
+    }
+    if (gameState.checksum() != replay.recordedChecksum()) {
+        std::cerr << "Replay diverged: checksum " << std::hex << gameState.checksum() << ", recorded "
+                  << replay.recordedChecksum() << std::dec << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "Replay matches the recorded session" << std::endl;
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char* argv[]) {
+    ServerConfig config = parseServerConfig(argc, argv);
+#ifdef TANK_HEADLESS
+    config.headless = true;
+#endif
+
     // Register signal handlers
     std::signal(SIGINT, signalHandler);
     std::signal(SIGTERM, signalHandler);
 
+    Trace::setThreadName("simulation");
+    if (!config.tracePath.empty() && !Trace::open(config.tracePath)) {
+        std::cerr << "Not tracing: cannot write " << config.tracePath
+                  << " or built without -DTANK_TRACE=ON" << std::endl;
+    }
+
+    if (!config.replayPath.empty()) {
+        int status = runReplay(config);
+        Trace::write();
+        return status;
+    }
+
+#ifndef TANK_HEADLESS
+    if (!config.headless) {
+        // Decode every texture and font once, before any enemy is spawned
+        AssetCache::preload(
+                {"Assets/body.png", "Assets/turret.png", "Assets/enemy.png"},
+                {"Assets/arial.ttf"});
+        AssetCache::reportStats(std::cout);
+    }
+#endif
+
+    if (!config.telemetryPath.empty()) {
+        Telemetry::startDumping(config.telemetryPath, config.telemetryInterval);
+    }
+
     // Start the TCP server
-    GameServer server(8080);
+    GameServer server(config.port);
     server.start();
 
-    GameState gameState;
+    std::uint32_t seed = config.seed != 0 ? config.seed : std::random_device{}();
+    std::cout << "Simulation seed: " << seed << std::endl;
+    GameState gameState(seed);
     gameState.setServer(&server);
-    server.setGameState(&gameState);
-    GameRender renderer;
 
-    // Track movement and rotation separately.
-    Direction lastDir = Direction::RIGHT;
+    Replay::Writer recorder;
+    if (!config.recordPath.empty() && !recorder.open(config.recordPath, seed, config.tickRate)) {
+        std::cerr << "Cannot write replay " << config.recordPath << "; not recording" << std::endl;
+    }
+
+    // Simulation publishes a snapshot per tick; the renderer only reads those
+    SnapshotBuffer snapshots;
+    std::uint64_t tick = 0;
+    gameState.writeSnapshot(snapshots.beginWrite());
+    snapshots.publish();
+
+    // Per-tick deltas for clients that subscribe to the state stream
+    StateStream stateStream;
+    FrameSnapshot stateSnapshot;
 
     // Atomic flag for render thread
     std::atomic<bool> renderThreadRunning{true};
+    std::thread renderThread;
 
-    // Launch rendering in a separate thread.
-    std::thread renderThread([&]() {
-        renderer.run(gameState, lastDir, renderThreadRunning);
-    });
+#ifndef TANK_HEADLESS
+    // Launch rendering in a separate thread (no window at all when headless).
+    std::unique_ptr<GameRender> renderer;
+    if (!config.headless) {
+        renderer = std::make_unique<GameRender>(config.batchedRender);
+        renderThread = std::thread([&]() {
+            renderer->run(snapshots, renderThreadRunning);
+        });
+    }
+#endif
 
-    // Main game loop (~60 FPS)
+    // Main game loop: fixed-length ticks at config.tickRate
+    FixedTimestep timestep(config.tickRate, config.maxCatchUpTicks);
     bool gameOverNotified = false;
     auto gameOverStart = std::chrono::steady_clock::time_point();
+    auto lastLoop = std::chrono::steady_clock::now();
+    auto runStart = lastLoop;
 
     while (!ShutdownModule::isShutdownRequested()) {
-        auto frameStart = std::chrono::steady_clock::now();
+        auto loopStart = std::chrono::steady_clock::now();
+        // Unthrottled runs one tick per loop back to back, faster than real time
+        int ticksDue = config.unthrottled
+                       ? 1
+                       : timestep.advance(std::chrono::duration<double>(loopStart - lastLoop).count());
+        lastLoop = loopStart;
 
-        {
-            // Lock the game state while updating.
-            std::lock_guard<std::recursive_mutex> lock(gameState.getMutex());
+        if (ticksDue > 0) {
+            TRACE_ZONE("main loop ticks");
+            Telemetry::ScopedTimer loopTimer(Telemetry::simLoop);
+            Telemetry::catchUpTicks.add(static_cast<std::uint64_t>(ticksDue - 1));
 
-            // Get all inputs at once.
-            Direction currentDir = server.getCurrentDirection();
-            int rotationDelta = server.getTurretRotationDelta();
-            bool buttonPressed = server.getButtonPressed();
+            for (int i = 0; i < ticksDue; ++i) {
+                // Catch-up ticks stand for earlier moments, so each only takes
+                // the input that had arrived by its share of the wall time
+                auto deadline = loopStart - std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                        std::chrono::duration<double>(timestep.dt() * (ticksDue - 1 - i)));
+                TickInput input = server.sampleInput(0, deadline);
+                recorder.record(input);
 
-            // Update tank if direction changed.
-            if (currentDir != Direction::NONE) {
-                lastDir = currentDir;
-                gameState.updateTankPosition(currentDir);
+                auto stepStart = std::chrono::steady_clock::now();
+                gameState.step(input, timestep.dt());
+                Telemetry::simTick.recordSince(stepStart);
+                Telemetry::ticks.add();
+                ++tick;
             }
 
-            // Update turret if rotation changed.
-            if (rotationDelta != 0) {
-                gameState.updateTurretRotation(rotationDelta);
+            // Hand the newest tick to the renderer
+            if (!config.headless) {
+                FrameSnapshot &snap = snapshots.beginWrite();
+                gameState.writeSnapshot(snap);
+                snap.tick = tick;
+                snap.tickSeconds = timestep.dt();
+                snap.publishedAt = std::chrono::steady_clock::now();
+                snapshots.publish();
             }
 
-            // Fire if button pressed.
-            if (buttonPressed) {
-                gameState.fireProjectile();
-            }
-
-            // Handle enemy shooting
-            for (const auto &enemy: gameState.getEnemies()) {
-                if (enemy->canShoot() && enemy->isActive()) {
-                    float angle;
-                    switch (enemy->getDirection()) {
-                        case Direction::UP:
-                            angle = 0.0f;
-                            break;
-                        case Direction::RIGHT:
-                            angle = 90.0f;
-                            break;
-                        case Direction::DOWN:
-                            angle = 180.0f;
-                            break;
-                        case Direction::LEFT:
-                            angle = 270.0f;
-                            break;
-                        default:
-                            angle = 0.0f;
-                            break;
-                    }
-                    gameState.enemyFireProjectile(
-                            enemy->getPosition().x,
-                            enemy->getPosition().y,
-                            angle
-                    );
-                    enemy->resetShootTimer();
-                }
-            }
-
-            gameState.updateProjectiles();
-
             // Game Over Logic
             if (!gameState.isPlayerAlive() && !gameOverNotified) {
                 gameOverNotified = true;
@@ -112,6 +202,17 @@ int main() {
                 // Only send health updates if player is alive
                 server.sendTankHealth(gameState.getTank().health);
             }
+
+            if (server.hasStateSubscribers()) {
+                gameState.writeSnapshot(stateSnapshot);
+                stateSnapshot.tick = tick;
+                stateSnapshot.tickSeconds = timestep.dt();
+                const std::string &frame = stateStream.encode(stateSnapshot, server.takeKeyframeRequest());
+                server.sendState(frame, stateStream.lastWasKeyframe());
+            }
+
+            // One write per client for everything this tick produced
+            server.flush();
         }
 
         // If we have notified game over, wait 5 seconds, then shut down.
@@ -123,13 +224,35 @@ int main() {
             }
         }
 
-        auto frameEnd = std::chrono::steady_clock::now();
-        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(frameEnd - frameStart);
-        if (elapsed.count() < 16) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(16 - elapsed.count()));
+        if (config.maxTicks > 0 && tick >= config.maxTicks) {
+            ShutdownModule::requestShutdown();
+        }
+        if (config.unthrottled) {
+            continue;
+        }
+
+        // Sleep until the next tick is due (sub-millisecond resolution)
+        double untilNextTick = timestep.timeUntilNextTick()
+                               - std::chrono::duration<double>(std::chrono::steady_clock::now() - lastLoop).count();
+        if (untilNextTick > 0.0) {
+            std::this_thread::sleep_for(std::chrono::duration<double>(untilNextTick));
         }
     }
 
+    double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - runStart).count();
+    double simSeconds = static_cast<double>(tick) * timestep.dt();
+    std::cout << "Simulated " << tick << " ticks (" << simSeconds << " s) in " << wallSeconds << " s, "
+              << (wallSeconds > 0.0 ? simSeconds / wallSeconds : 0.0) << "x real time" << std::endl;
+
+    if (timestep.droppedTicks() > 0) {
+        std::cout << "Simulation fell behind; dropped " << timestep.droppedTicks() << " ticks" << std::endl;
+    }
+
+    if (recorder.isOpen()) {
+        recorder.finish(tick, gameState.checksum());
+        std::cout << "Recorded " << tick << " ticks to " << config.recordPath << std::endl;
+    }
+
     // Cleanup
     renderThreadRunning = false;
     try {
@@ -140,6 +263,8 @@ int main() {
         std::cerr << "Error joining render thread: " << e.what() << std::endl;
     }
 
+    Telemetry::stopDumping();
+    Trace::write();
     std::cout << "Server shutdown complete" << std::endl;
     return 0;
 }
@@ -0,0 +1,92 @@
+#include "../include/AssetCache.h"
+#include <chrono>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+
+std::mutex AssetCache::mtx;
+std::unordered_map<std::string, std::shared_ptr<const sf::Texture>> AssetCache::textures;
+std::unordered_map<std::string, std::shared_ptr<const sf::Font>> AssetCache::fonts;
+std::vector<std::pair<std::string, AssetCache::AssetInfo>> AssetCache::loadLog;
+
+std::shared_ptr<const sf::Texture> AssetCache::getTexture(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mtx);
+    auto it = textures.find(path);
+    if (it != textures.end()) {
+        return it->second;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    auto texture = std::make_shared<sf::Texture>();
+    bool loaded = texture->loadFromFile(path);
+    if (!loaded) {
+        std::cerr << "Failed to load " << path << std::endl;
+    }
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    // Textures live on the GPU as RGBA8
+    sf::Vector2u size = texture->getSize();
+    recordLoad(path, ms, static_cast<size_t>(size.x) * size.y * 4, loaded);
+
+    // Failed loads are cached too so we don't retry the disk every spawn
+    std::shared_ptr<const sf::Texture> handle = std::move(texture);
+    textures.emplace(path, handle);
+    return handle;
+}
+
+std::shared_ptr<const sf::Font> AssetCache::getFont(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mtx);
+    auto it = fonts.find(path);
+    if (it != fonts.end()) {
+        return it->second;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    auto font = std::make_shared<sf::Font>();
+    bool loaded = font->loadFromFile(path);
+    if (!loaded) {
+        std::cerr << "Failed to load " << path << std::endl;
+    }
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    // Glyph pages are built lazily; the font file size is the baseline cost
+    std::error_code ec;
+    auto fileSize = std::filesystem::file_size(path, ec);
+    recordLoad(path, ms, ec ? 0 : static_cast<size_t>(fileSize), loaded);
+
+    std::shared_ptr<const sf::Font> handle = std::move(font);
+    fonts.emplace(path, handle);
+    return handle;
+}
+
+void AssetCache::preload(const std::vector<std::string>& texturePaths,
+                         const std::vector<std::string>& fontPaths) {
+    for (const auto& path : texturePaths) {
+        getTexture(path);
+    }
+    for (const auto& path : fontPaths) {
+        getFont(path);
+    }
+}
+
+void AssetCache::reportStats(std::ostream& out) {
+    std::lock_guard<std::mutex> lock(mtx);
+    double totalMs = 0.0;
+    size_t totalBytes = 0;
+
+    out << "Asset cache (" << loadLog.size() << " assets):" << std::endl;
+    for (const auto& [path, info] : loadLog) {
+        out << "  " << std::left << std::setw(24) << path
+            << std::right << std::fixed << std::setprecision(2) << std::setw(8) << info.loadMs << " ms "
+            << std::setw(8) << info.bytes / 1024 << " KiB"
+            << (info.loaded ? "" : "  (FAILED)") << std::endl;
+        totalMs += info.loadMs;
+        totalBytes += info.bytes;
+    }
+    out << "  total " << std::fixed << std::setprecision(2) << totalMs << " ms, "
+        << totalBytes / 1024 << " KiB" << std::endl;
+}
+
+void AssetCache::recordLoad(const std::string& path, double loadMs, size_t bytes, bool loaded) {
+    loadLog.push_back({path, {loadMs, bytes, loaded}});
+}
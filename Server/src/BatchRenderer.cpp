@@ -0,0 +1,95 @@
+#include "../include/BatchRenderer.h"
+#include "../include/AssetCache.h"
+#include "../include/Enemy.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+BatchRenderer::BatchRenderer() : vertices(sf::Quads) {
+    auto enemyTexture = AssetCache::getTexture("Assets/enemy.png");
+
+    // Bake the enemy at its on-screen size so quads map texels 1:1
+    float enemyW = std::ceil(enemyTexture->getSize().x * ENEMY_SPRITE_SCALE);
+    float enemyH = std::ceil(enemyTexture->getSize().y * ENEMY_SPRITE_SCALE);
+    float discSize = DISC_RADIUS * 2.0f;
+
+    unsigned atlasW = static_cast<unsigned>(enemyW + ATLAS_PADDING + discSize);
+    unsigned atlasH = static_cast<unsigned>(std::max(enemyH, discSize));
+
+    sf::RenderTexture atlasTarget;
+    if (!atlasTarget.create(std::max(1u, atlasW), std::max(1u, atlasH))) {
+        std::cerr << "Failed to create render texture for sprite atlas." << std::endl;
+    }
+    atlasTarget.clear(sf::Color::Transparent);
+
+    sf::Sprite enemySprite(*enemyTexture);
+    enemySprite.setScale(ENEMY_SPRITE_SCALE, ENEMY_SPRITE_SCALE);
+    atlasTarget.draw(enemySprite);
+    enemyRect = sf::FloatRect(0.f, 0.f, enemyW, enemyH);
+
+    // White disc; projectiles and spawn indicators tint it per vertex
+    sf::CircleShape disc(DISC_RADIUS, 64);
+    disc.setFillColor(sf::Color::White);
+    disc.setPosition(enemyW + ATLAS_PADDING, 0.f);
+    atlasTarget.draw(disc);
+    discRect = sf::FloatRect(enemyW + ATLAS_PADDING, 0.f, discSize, discSize);
+
+    atlasTarget.display();
+    atlas = atlasTarget.getTexture();
+    atlas.setSmooth(true);
+}
+
+void BatchRenderer::begin() {
+    vertices.clear();
+}
+
+void BatchRenderer::addProjectile(float x, float y, bool isEnemy) {
+    // Matches the legacy CircleShape: radius 5 with its origin at (2.5, 2.5)
+    float offset = PROJECTILE_RADIUS / 2.0f;
+    addQuad(x + offset, y + offset, PROJECTILE_RADIUS, PROJECTILE_RADIUS, 0, discRect,
+            isEnemy ? sf::Color::Yellow : sf::Color::Red);
+}
+
+void BatchRenderer::addSpawnIndicator(float x, float y) {
+    float r = Enemy::getRadius();
+    addQuad(x, y, r, r, 0, discRect, sf::Color(255, 0, 0, 150));
+}
+
+void BatchRenderer::addEnemy(float x, float y, Direction dir) {
+    int steps;
+    switch (dir) {
+        case Direction::RIGHT: steps = 1; break;
+        case Direction::DOWN: steps = 2; break;
+        case Direction::LEFT: steps = 3; break;
+        default: steps = 0; break;
+    }
+    addQuad(x, y, enemyRect.width / 2.0f, enemyRect.height / 2.0f, steps, enemyRect, sf::Color::White);
+}
+
+void BatchRenderer::flush(sf::RenderTarget& target) {
+    if (vertices.getVertexCount() > 0) {
+        target.draw(vertices, sf::RenderStates(&atlas));
+    }
+}
+
+// Append a quad centred on (cx, cy), rotated clockwise by rotationSteps * 90 degrees
+void BatchRenderer::addQuad(float cx, float cy, float halfW, float halfH, int rotationSteps,
+                            const sf::FloatRect& texRect, const sf::Color& color) {
+    static const float COS[4] = {1.f, 0.f, -1.f, 0.f};
+    static const float SIN[4] = {0.f, 1.f, 0.f, -1.f};
+    const float c = COS[rotationSteps & 3];
+    const float s = SIN[rotationSteps & 3];
+
+    const sf::Vector2f local[4] = {{-halfW, -halfH}, {halfW, -halfH}, {halfW, halfH}, {-halfW, halfH}};
+    const sf::Vector2f tex[4] = {
+            {texRect.left, texRect.top},
+            {texRect.left + texRect.width, texRect.top},
+            {texRect.left + texRect.width, texRect.top + texRect.height},
+            {texRect.left, texRect.top + texRect.height}};
+
+    for (int i = 0; i < 4; ++i) {
+        sf::Vector2f pos(cx + local[i].x * c - local[i].y * s,
+                         cy + local[i].x * s + local[i].y * c);
+        vertices.append(sf::Vertex(pos, color, tex[i]));
+    }
+}
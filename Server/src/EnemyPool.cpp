@@ -0,0 +1,5 @@
+#include "../include/EnemyPool.h"
+
+Enemy &EnemyPool::spawn(float x, float y, Direction dir, std::uint32_t id) {
+    return enemies.emplace_back(x, y, dir, id);
+}
@@ -0,0 +1,25 @@
+#include "../include/FixedTimestep.h"
+#include <algorithm>
+#include <cmath>
+
+FixedTimestep::FixedTimestep(double tickRateHz, int maxCatchUpTicks)
+        : tickSeconds(1.0 / std::max(1.0, tickRateHz)),
+          accumulator(0.0),
+          maxCatchUp(std::max(1, maxCatchUpTicks)),
+          dropped(0) {
+}
+
+int FixedTimestep::advance(double elapsedSeconds) {
+    accumulator += std::max(0.0, elapsedSeconds);
+
+    auto due = static_cast<std::uint64_t>(std::floor(accumulator / tickSeconds));
+    accumulator -= static_cast<double>(due) * tickSeconds;
+
+    // Too far behind: run the limit and forget the rest of the backlog
+    if (due > static_cast<std::uint64_t>(maxCatchUp)) {
+        dropped += due - static_cast<std::uint64_t>(maxCatchUp);
+        due = maxCatchUp;
+    }
+
+    return static_cast<int>(due);
+}
@@ -2,11 +2,21 @@
 #include <iostream>
 #include <cstdlib>
 #include <ctime>
-#include <mutex>
+#include <chrono>
+#include <algorithm>
 #include "Shutdown.h"
+#include "AssetCache.h"
+#include "Enemy.h"
+#include "Telemetry.h"
+#include "Trace.h"
 
-GameRender::GameRender()
-        : window(sf::VideoMode(1024, 768), "Tank Game") {
+static float lerp(float from, float to, float t) {
+    return from + (to - from) * t;
+}
+
+GameRender::GameRender(bool batchedRender)
+        : window(sf::VideoMode(1024, 768), "Tank Game"),
+          batched(batchedRender) {
 
     // Generate a grass background texture.
     sf::RenderTexture grassRenderTexture;
@@ -40,19 +50,15 @@ GameRender::GameRender()
     backgroundTexture = grassRenderTexture.getTexture();
     backgroundSprite.setTexture(backgroundTexture);
 
-    // Load the tank body and turret images.
-    if (!bodyTexture.loadFromFile("Assets/body.png")) {
-        std::cerr << "Failed to load body.png" << std::endl;
-    }
-    if (!turretTexture.loadFromFile("Assets/turret.png")) {
-        std::cerr << "Failed to load turret.png" << std::endl;
-    }
-    bodySprite.setTexture(bodyTexture);
-    turretSprite.setTexture(turretTexture);
+    // Tank body and turret images come from the shared asset cache.
+    bodyTexture = AssetCache::getTexture("Assets/body.png");
+    turretTexture = AssetCache::getTexture("Assets/turret.png");
+    bodySprite.setTexture(*bodyTexture);
+    turretSprite.setTexture(*turretTexture);
 
     // Set the origin to the center so rotations look natural.
-    bodySprite.setOrigin(bodyTexture.getSize().x / 2.0f, bodyTexture.getSize().y / 2.0f);
-    turretSprite.setOrigin(turretTexture.getSize().x / 2.0f, turretTexture.getSize().y / 2.0f);
+    bodySprite.setOrigin(bodyTexture->getSize().x / 2.0f, bodyTexture->getSize().y / 2.0f);
+    turretSprite.setOrigin(turretTexture->getSize().x / 2.0f, turretTexture->getSize().y / 2.0f);
 
     // Scale the images up 4× compared to the previous size.
     bodySprite.setScale(0.20f, 0.20f);
@@ -63,25 +69,30 @@ GameRender::GameRender()
     projectileShape.setFillColor(sf::Color::Red);
     projectileShape.setOrigin(2.5f, 2.5f);
 
+    // Enemy sprite and spawn indicator (legacy path)
+    enemyTexture = AssetCache::getTexture("Assets/enemy.png");
+    enemySprite.setTexture(*enemyTexture);
+    enemySprite.setOrigin(enemyTexture->getSize().x / 2.0f, enemyTexture->getSize().y / 2.0f);
+    enemySprite.setScale(BatchRenderer::ENEMY_SPRITE_SCALE, BatchRenderer::ENEMY_SPRITE_SCALE);
+
+    spawnIndicator.setRadius(Enemy::getRadius());
+    spawnIndicator.setFillColor(sf::Color(255, 0, 0, 150));
+    spawnIndicator.setOrigin(Enemy::getRadius(), Enemy::getRadius());
+
     // Hit effect
     hitEffect.setSize(sf::Vector2f(50, 50));
     hitEffect.setFillColor(sf::Color(255, 0, 0, 150));
     hitEffect.setOrigin(25, 25);
 
     // For Game Over Text
-    if (!gameOverFont.loadFromFile("Assets/arial.ttf")) {
-        std::cerr << "Failed to load font for game over text" << std::endl;
-    }
-    gameOverText.setFont(gameOverFont);
+    uiFont = AssetCache::getFont("Assets/arial.ttf");
+    gameOverText.setFont(*uiFont);
     gameOverText.setCharacterSize(100);
     gameOverText.setFillColor(sf::Color::Red);
     gameOverText.setString("GAME OVER");
 
     // For Wave Text
-    if (!waveFont.loadFromFile("Assets/arial.ttf")) {
-        std::cerr << "Failed to load font for wave text" << std::endl;
-    }
-    waveText.setFont(waveFont);
+    waveText.setFont(*uiFont);
     waveText.setCharacterSize(30);
     waveText.setFillColor(sf::Color::White);
     waveText.setOutlineColor(sf::Color::Black);
@@ -91,10 +102,9 @@ GameRender::GameRender()
     overlay.setFillColor(sf::Color(0, 0, 0, 128));
 }
 
-void GameRender::run(GameState &state, Direction &lastDir, std::atomic<bool>& running) {
+void GameRender::run(SnapshotBuffer &snapshots, std::atomic<bool>& running) {
+    Trace::setThreadName("render");
     while (window.isOpen() && running && !ShutdownModule::isShutdownRequested()) {
-        float dt = deltaClock.restart().asSeconds();
-
         // Handle window events.
         sf::Event event;
         while (window.pollEvent(event)) {
@@ -103,78 +113,80 @@ void GameRender::run(GameState &state, Direction &lastDir, std::atomic<bool>& ru
                 ShutdownModule::requestShutdown();
                 break;
             }
+            if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::F1) {
+                // Report the old path's average before switching
+                recordFrameTime(-1.0f, 0);
+                batched = !batched;
+                std::cout << "Render path: " << (batched ? "batched" : "legacy") << std::endl;
+            }
         }
 
+        // One zone per frame; the pacing sleep is a child zone
+        TRACE_ZONE("GameRender::run frame");
+        sf::Clock frameTimer;
+        auto frameStart = std::chrono::steady_clock::now();
         window.clear();
         window.draw(backgroundSprite);
 
-        {
-            // Lock the game state during update and drawing.
-            std::lock_guard<std::recursive_mutex> lock(state.getMutex());
-
-            // Only draw tank if player is alive
-            if (state.isPlayerAlive()) {
-                const Tank &tank = state.getTank();
-                bodySprite.setPosition(tank.x, tank.y);
-                turretSprite.setPosition(tank.x, tank.y);
-
-                auto getAngleForDirection = [](Direction dir) -> float {
-                    switch (dir) {
-                        case Direction::UP:
-                            return 0.0f;
-                        case Direction::RIGHT:
-                            return 90.0f;
-                        case Direction::DOWN:
-                            return 180.0f;
-                        case Direction::LEFT:
-                            return 270.0f;
-                        default:
-                            return 90.0f;
-                    }
-                };
-
-                bodySprite.setRotation(getAngleForDirection(lastDir));
-                turretSprite.setRotation(state.getTurretAngle());
-
-                // Draw hit effect if active
-                if (state.getTankHitEffect() > 0) {
-                    hitEffect.setPosition(tank.x, tank.y);
-                    window.draw(hitEffect);
+        const FrameSnapshot &snap = snapshots.acquire();
+
+        // Blend from the previous tick towards this one by how far we are into the next tick
+        float sinceTick = std::chrono::duration<float>(std::chrono::steady_clock::now() - snap.publishedAt).count();
+        Telemetry::snapshotAge.record(static_cast<std::uint64_t>(sinceTick * 1e9f));
+        float alpha = std::max(0.0f, std::min(sinceTick / snap.tickSeconds, 1.0f));
+
+        // Only draw tank if player is alive
+        if (snap.playerAlive) {
+            float tankX = lerp(snap.tankPrevX, snap.tank.x, alpha);
+            float tankY = lerp(snap.tankPrevY, snap.tank.y, alpha);
+            bodySprite.setPosition(tankX, tankY);
+            turretSprite.setPosition(tankX, tankY);
+
+            auto getAngleForDirection = [](Direction dir) -> float {
+                switch (dir) {
+                    case Direction::UP:
+                        return 0.0f;
+                    case Direction::RIGHT:
+                        return 90.0f;
+                    case Direction::DOWN:
+                        return 180.0f;
+                    case Direction::LEFT:
+                        return 270.0f;
+                    default:
+                        return 90.0f;
                 }
+            };
 
-                window.draw(bodySprite);
-                window.draw(turretSprite);
-            }
+            bodySprite.setRotation(getAngleForDirection(snap.tankDirection));
+            turretSprite.setRotation(snap.turretAngle);
 
-            // Draw projectiles.
-            for (const auto &p: state.getProjectiles()) {
-                projectileShape.setPosition(p.x, p.y);
-                projectileShape.setFillColor(p.isEnemyProjectile ? sf::Color::Yellow : sf::Color::Red);
-                window.draw(projectileShape);
+            // Draw hit effect if active
+            if (snap.tankHitEffect > 0) {
+                hitEffect.setPosition(tankX, tankY);
+                window.draw(hitEffect);
             }
 
-            // Update and draw enemies.
-            for (const auto &enemy: state.getEnemies()) {
-                enemy->update(dt);
-                enemy->draw(window);
-            }
+            window.draw(bodySprite);
+            window.draw(turretSprite);
         }
 
+        size_t quads = batched ? drawEntitiesBatched(snap, alpha) : drawEntitiesLegacy(snap, alpha);
+
         // Draw UI elements (after game objects)
-        if (state.isPlayerAlive()) {
-            waveText.setString("Wave: " + std::to_string(state.getCurrentWave()));
+        if (snap.playerAlive) {
+            waveText.setString("Wave: " + std::to_string(snap.wave));
             sf::FloatRect textRect = waveText.getLocalBounds();
             waveText.setOrigin(textRect.width / 2.0f, textRect.height / 2.0f);
             waveText.setPosition(1024.f / 2.0f, 30.f);
             window.draw(waveText);
         }
 
-        if (!state.isPlayerAlive()) {
+        if (!snap.playerAlive) {
             // Draw a semi-transparent overlay
             overlay.setPosition(0.f, 0.f);
             window.draw(overlay);
 
-            gameOverText.setString("GAME OVER\nWave: " + std::to_string(state.getCurrentWave()));
+            gameOverText.setString("GAME OVER\nWave: " + std::to_string(snap.wave));
             sf::FloatRect textRect = gameOverText.getLocalBounds();
             gameOverText.setOrigin(textRect.width / 2.0f, textRect.height / 2.0f);
             gameOverText.setPosition(1024.f / 2.0f, 768.f / 2.0f);
@@ -182,7 +194,12 @@ void GameRender::run(GameState &state, Direction &lastDir, std::atomic<bool>& ru
         }
 
         window.display();
-        sf::sleep(sf::milliseconds(16));
+        Telemetry::renderFrame.recordSince(frameStart);
+        recordFrameTime(frameTimer.getElapsedTime().asMicroseconds() / 1000.0f, quads);
+        {
+            TRACE_ZONE("GameRender::run sleep");
+            sf::sleep(sf::milliseconds(16));
+        }
     }
 
     // Clean up SFML resources while OpenGL context is still valid
@@ -197,6 +214,78 @@ void GameRender::run(GameState &state, Direction &lastDir, std::atomic<bool>& ru
     backgroundSprite = sf::Sprite();
 }
 
+size_t GameRender::drawEntitiesLegacy(const FrameSnapshot &snap, float alpha) {
+    size_t draws = snap.projectiles.size();
+
+    // Draw projectiles.
+    for (const auto &p: snap.projectiles) {
+        projectileShape.setPosition(lerp(p.prevX, p.x, alpha), lerp(p.prevY, p.y, alpha));
+        projectileShape.setFillColor(p.isEnemy ? sf::Color::Yellow : sf::Color::Red);
+        window.draw(projectileShape);
+    }
+
+    // Draw enemies.
+    for (const auto &e: snap.enemies) {
+        if (e.spawning) {
+            spawnIndicator.setPosition(e.x, e.y);
+            window.draw(spawnIndicator);
+            draws++;
+        } else if (e.active) {
+            enemySprite.setPosition(e.x, e.y);
+            switch (e.direction) {
+                case Direction::UP: enemySprite.setRotation(0); break;
+                case Direction::RIGHT: enemySprite.setRotation(90); break;
+                case Direction::DOWN: enemySprite.setRotation(180); break;
+                case Direction::LEFT: enemySprite.setRotation(270); break;
+                default: break;
+            }
+            window.draw(enemySprite);
+            draws++;
+        }
+    }
+    return draws;
+}
+
+size_t GameRender::drawEntitiesBatched(const FrameSnapshot &snap, float alpha) {
+    batchRenderer.begin();
+
+    for (const auto &p: snap.projectiles) {
+        batchRenderer.addProjectile(lerp(p.prevX, p.x, alpha), lerp(p.prevY, p.y, alpha), p.isEnemy);
+    }
+
+    for (const auto &e: snap.enemies) {
+        if (e.spawning) {
+            batchRenderer.addSpawnIndicator(e.x, e.y);
+        } else if (e.active) {
+            batchRenderer.addEnemy(e.x, e.y, e.direction);
+        }
+    }
+
+    batchRenderer.flush(window);
+    return batchRenderer.quadCount();
+}
+
+// Accumulate frame times and quad counts and print their averages every
+// FRAME_TIME_WINDOW frames.
+// A negative sample flushes the current window early (used when switching paths).
+void GameRender::recordFrameTime(float ms, size_t quads) {
+    if (ms >= 0.0f) {
+        frameTimeAccumMs += ms;
+        quadAccum += quads;
+        frameTimeSamples++;
+    }
+
+    if (frameTimeSamples > 0 && (ms < 0.0f || frameTimeSamples >= FRAME_TIME_WINDOW)) {
+        std::cout << "Render (" << (batched ? "batched" : "legacy") << "): "
+                  << frameTimeAccumMs / frameTimeSamples << " ms/frame, "
+                  << static_cast<float>(quadAccum) / frameTimeSamples << " quads/frame over "
+                  << frameTimeSamples << " frames" << std::endl;
+        frameTimeAccumMs = 0.0f;
+        quadAccum = 0;
+        frameTimeSamples = 0;
+    }
+}
+
 GameRender::~GameRender() {
     window.close();
 }
\ No newline at end of file
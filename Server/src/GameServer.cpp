@@ -1,18 +1,36 @@
 #include "../include/GameServer.h"
 #include "../include/GameState.h"
+#include "../include/InputProtocol.h"
+#include "../include/Telemetry.h"
+#include "../include/Trace.h"
 #include "Shutdown.h"
+#include <cerrno>
+#include <charconv>
 #include <cstring>
 #include <arpa/inet.h>
-#include <thread>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
 #include <iostream>
 #include <unistd.h>
 
+static_assert(GameState::PLAYER_SLOTS >= 1, "need at least one player slot");
 
-GameServer::GameServer(int port) :
-        currentDirection(Direction::NONE),
-        turretRotationDelta(0),
-        buttonPressed(false) {
-    server_fd = socket(AF_INET, SOCK_STREAM, 0);
+namespace {
+    constexpr int MAX_EVENTS = 64;
+
+    // Take the lock, recording the wait on the calling thread's histogram
+    std::unique_lock<std::mutex> lockTimed(std::mutex &mutex, Telemetry::Histogram &wait) {
+        auto start = std::chrono::steady_clock::now();
+        std::unique_lock<std::mutex> lock(mutex);
+        wait.recordSince(start);
+        return lock;
+    }
+}
+
+GameServer::GameServer(int port) {
+    server_fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
     if (server_fd == -1) {
         perror("Socket creation failed");
         exit(EXIT_FAILURE);
@@ -36,153 +54,641 @@ GameServer::GameServer(int port) :
     }
 
     // Start listening
-    if (listen(server_fd, 1) < 0) {
+    if (listen(server_fd, SOMAXCONN) < 0) {
         perror("Listen failed");
         exit(EXIT_FAILURE);
     }
 
+    // Optional low-latency input channel on the same port
+    udp_fd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (udp_fd == -1 || bind(udp_fd, (struct sockaddr *) &server_addr, sizeof(server_addr))) {
+        perror("UDP input channel unavailable");
+        if (udp_fd != -1) close(udp_fd);
+        udp_fd = -1;
+    }
+
+    // One epoll set watches the listeners, every client and the wake-up eventfd
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epoll_fd == -1 || wake_fd == -1) {
+        perror("epoll setup failed");
+        exit(EXIT_FAILURE);
+    }
+
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.fd = server_fd;
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, server_fd, &ev);
+    ev.data.fd = wake_fd;
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wake_fd, &ev);
+    if (udp_fd != -1) {
+        ev.data.fd = udp_fd;
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, udp_fd, &ev);
+    }
+
+    for (int &owner: slotOwner) {
+        owner = -1;
+    }
+    for (Direction &held: heldDirection) {
+        held = Direction::NONE;
+    }
+
     std::cout << "Server started on port " << port << std::endl;
     registerServerCleanup();
 }
 
 GameServer::~GameServer() {
     stop();
+    if (networkThread.joinable()) {
+        networkThread.join();
+    }
+    close(epoll_fd);
+    close(wake_fd);
 }
 
 void GameServer::start() {
-    addr_len = sizeof(client_addr);
-    client_fd = accept(server_fd, (struct sockaddr *) &client_addr, &addr_len);
-    if (client_fd < 0) {
-        if (!ShutdownModule::isShutdownRequested()) {
-            perror("Accept failed");
-            exit(EXIT_FAILURE);
-        }
-        return;
-    }
-
-    std::cout << "Client connected: " << inet_ntoa(client_addr.sin_addr) << std::endl;
-
-    // Start receiving input in a separate thread
-    std::thread inputThread(&GameServer::receiveInput, this);
-    inputThread.detach();
+    running = true;
+    networkThread = std::thread(&GameServer::networkLoop, this);
 }
 
-Direction GameServer::getCurrentDirection() const {
-    return currentDirection;
+// Only flips a flag and writes the eventfd, so it is safe from a signal handler
+void GameServer::stop() {
+    if (running.exchange(false)) {
+        wakeNetworkThread();
+    }
 }
 
-int GameServer::getTurretRotationDelta() {
-    int delta = turretRotationDelta;
-    turretRotationDelta = 0;
-    return delta;
+void GameServer::wakeNetworkThread() {
+    uint64_t one = 1;
+    ssize_t ignored = write(wake_fd, &one, sizeof(one));
+    (void) ignored;
 }
 
-bool GameServer::getButtonPressed() {
-    bool pressed = buttonPressed;
-    buttonPressed = false;
-    return pressed;
-}
+void GameServer::networkLoop() {
+    Trace::setThreadName("network");
+    epoll_event events[MAX_EVENTS];
 
-void GameServer::receiveInput() {
-    char buffer[32];
+    while (running) {
+        int n = epoll_wait(epoll_fd, events, MAX_EVENTS, -1);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            perror("epoll_wait failed");
+            break;
+        }
 
-    // Send initial state request
-    const char *init_request = "INIT";
-    write(client_fd, init_request, strlen(init_request));
+        for (int i = 0; i < n; ++i) {
+            int fd = events[i].data.fd;
+
+            if (fd == server_fd) {
+                acceptClients();
+                continue;
+            }
+
+            if (fd == udp_fd) {
+                readDatagrams();
+                continue;
+            }
+
+            if (fd == wake_fd) {
+                uint64_t count;
+                ssize_t ignored = read(wake_fd, &count, sizeof(count));
+                (void) ignored;
+                flushAll();
+                continue;
+            }
+
+            auto it = connections.find(fd);
+            if (it == connections.end()) continue;
+
+            if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+                std::cout << "Client disconnected." << std::endl;
+                closeClient(fd);
+                continue;
+            }
+            if (events[i].events & EPOLLIN) {
+                readClient(it->second);
+            }
+            // readClient may have closed the connection
+            it = connections.find(fd);
+            if (it != connections.end() && (events[i].events & EPOLLOUT) && !flushClient(it->second)) {
+                closeClient(fd);
+            }
+        }
+    }
 
+    closeAll();
+    if (droppedStateFrames > 0 || slowClientsClosed > 0) {
+        std::cout << "Backpressure: skipped " << droppedStateFrames << " state frames, closed "
+                  << slowClientsClosed << " slow clients" << std::endl;
+    }
+    std::uint64_t overflowedInputs = 0;
+    for (const InputRing &ring: inputs) {
+        overflowedInputs += ring.dropped();
+    }
+    if (overflowedInputs > 0) {
+        std::cout << "Input ring full; dropped " << overflowedInputs << " input events" << std::endl;
+    }
+    if (staleDatagramFrames > 0) {
+        std::cout << "Dropped " << staleDatagramFrames << " stale or duplicate UDP input frames" << std::endl;
+    }
+    std::cout << "Server stopped" << std::endl;
+}
+
+void GameServer::acceptClients() {
     while (true) {
-        memset(buffer, 0, sizeof(buffer));
-        int bytesRead = read(client_fd, buffer, sizeof(buffer));
+        sockaddr_in client_addr{};
+        socklen_t addr_len = sizeof(client_addr);
+        int fd = accept4(server_fd, (struct sockaddr *) &client_addr, &addr_len,
+                         SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR && running) {
+                perror("Accept failed");
+            }
+            return;
+        }
 
-        if (bytesRead <= 0) {
-            std::cout << "Client disconnected." << std::endl;
-            break;
+        Connection conn;
+        conn.fd = fd;
+
+        // First free player slot, otherwise the client only spectates
+        for (int slot = 0; slot < GameState::PLAYER_SLOTS && slot < MAX_PLAYER_SLOTS; ++slot) {
+            if (slotOwner[slot] == -1) {
+                slotOwner[slot] = fd;
+                conn.slot = slot;
+                break;
+            }
+        }
+
+        // Send initial state request, and players a token for UDP input
+        conn.pending = "INIT\n";
+        if (conn.slot >= 0 && udp_fd != -1) {
+            do {
+                conn.udpToken = tokenRng();
+            } while (conn.udpToken == 0 || udpTokens.count(conn.udpToken));
+            udpTokens[conn.udpToken] = fd;
+            conn.pending += "UDP:" + std::to_string(conn.udpToken) + "\n";
+        }
+        conn.queuedBytes = conn.pending.size();
+
+        Connection *added;
+        {
+            std::lock_guard<std::mutex> lock(writeMutex);
+            if (lastHealth != NO_HEALTH) {
+                conn.pending += "HP:" + std::to_string(lastHealth) + "\n";
+                conn.queuedBytes = conn.pending.size();
+            }
+            added = &connections.emplace(fd, std::move(conn)).first->second;
+        }
+        ++clientCount;
+
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = fd;
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev);
+
+        if (added->slot >= 0) {
+            std::cout << "Client connected: " << inet_ntoa(client_addr.sin_addr)
+                      << " (player " << added->slot + 1 << ")" << std::endl;
+        } else {
+            std::cout << "Client connected: " << inet_ntoa(client_addr.sin_addr)
+                      << " (spectator)" << std::endl;
+        }
+        if (!flushClient(*added)) {
+            closeClient(fd);
+        }
+    }
+}
+
+// Drain the socket and handle every complete message in it
+void GameServer::readClient(Connection &conn) {
+    TRACE_ZONE("GameServer::readClient");
+    Telemetry::ScopedTimer timer(Telemetry::netRead);
+    char buffer[512];
+    bool disconnected = false;
+
+    while (true) {
+        ssize_t bytesRead = read(conn.fd, buffer, sizeof(buffer));
+        if (bytesRead > 0) {
+            conn.readBuf.append(buffer, bytesRead);
+            Telemetry::bytesIn.add(static_cast<std::uint64_t>(bytesRead));
+            continue;
+        }
+        if (bytesRead < 0 && errno == EINTR) {
+            continue;
         }
+        disconnected = !(bytesRead < 0 && (errno == EAGAIN || errno == EWOULDBLOCK));
+        break;
+    }
+
+    // The first byte decides the protocol for the life of the connection
+    if (conn.protocol == Protocol::UNKNOWN && !conn.readBuf.empty()) {
+        bool binary = static_cast<std::uint8_t>(conn.readBuf[0]) == InputProtocol::MAGIC;
+        conn.protocol = binary ? Protocol::BINARY : Protocol::TEXT;
+    }
+
+    size_t consumed = 0;
+    bool valid = conn.protocol == Protocol::BINARY
+                 ? processBinaryFrames(conn, consumed)
+                 : processTextMessages(conn, consumed);
+    conn.readBuf.erase(0, consumed);
 
-        std::string input(buffer);
+    if (disconnected) {
+        std::cout << "Client disconnected." << std::endl;
+        closeClient(conn.fd);
+        return;
+    }
 
-        // Reset state
-        currentDirection = Direction::NONE;
-        turretRotationDelta = 0;
-        buttonPressed = false;
+    if (!valid) {
+        std::cerr << "Client sent a malformed frame; disconnecting" << std::endl;
+        closeClient(conn.fd);
+        return;
+    }
 
-        // Process input
-        size_t start = 0;
-        size_t end = input.find(',');
+    // A client that never completes a message is not speaking the protocol
+    if (conn.readBuf.size() > MAX_READ_BUFFER) {
+        std::cerr << "Client sent an oversized message; disconnecting" << std::endl;
+        closeClient(conn.fd);
+    }
+}
 
-        while (end != std::string::npos) {
-            processInputToken(input.substr(start, end - start));
-            start = end + 1;
-            end = input.find(',', start);
+// Parse binary frames in place; false if the stream is corrupt
+bool GameServer::processBinaryFrames(Connection &conn, size_t &consumed) {
+    InputProtocol::Frame frame{};
+
+    while (consumed < conn.readBuf.size()) {
+        size_t frameLen = 0;
+        auto result = InputProtocol::parse(conn.readBuf.data() + consumed,
+                                           conn.readBuf.size() - consumed, frame, frameLen);
+        if (result == InputProtocol::ParseResult::NEED_MORE) return true;
+        if (result == InputProtocol::ParseResult::INVALID) return false;
+        consumed += frameLen;
+        if (result == InputProtocol::ParseResult::SKIPPED) continue;
+
+        // TCP keeps order, so an old sequence number is a client resend
+        if (conn.haveSeq && !InputProtocol::isNewer(frame.seq, conn.lastSeq)) continue;
+        conn.haveSeq = true;
+        conn.lastSeq = frame.seq;
+
+        if (frame.type == InputProtocol::FrameType::CHEAT) {
+            requestCheat(conn);
+        } else if (frame.type == InputProtocol::FrameType::SUBSCRIBE) {
+            subscribe(conn);
+        } else if (conn.slot >= 0) {
+            applyInput(conn.slot, frame.direction, frame.rotation, frame.fire);
         }
-        processInputToken(input.substr(start));
     }
+    return true;
 }
 
-void GameServer::processInputToken(const std::string& token) {
-    if (token == "UP") currentDirection = Direction::UP;
-    else if (token == "DOWN") currentDirection = Direction::DOWN;
-    else if (token == "LEFT") currentDirection = Direction::LEFT;
-    else if (token == "RIGHT") currentDirection = Direction::RIGHT;
-    else if (token.find("ROT:") == 0) {
-        turretRotationDelta += std::stoi(token.substr(4));
+// Each datagram repeats the client's last few inputs. Apply the ones newer
+// than anything seen so far, oldest first, and drop stale or duplicate ones.
+void GameServer::readDatagrams() {
+    TRACE_ZONE("GameServer::readDatagrams");
+    Telemetry::ScopedTimer timer(Telemetry::netDatagrams);
+    char buffer[256];
+    InputProtocol::Bundle bundle{};
+
+    while (true) {
+        ssize_t len = recv(udp_fd, buffer, sizeof(buffer), 0);
+        if (len < 0) {
+            if (errno == EINTR) continue;
+            return;
+        }
+        Telemetry::datagramsIn.add();
+        Telemetry::bytesIn.add(static_cast<std::uint64_t>(len));
+        if (!InputProtocol::parseBundle(buffer, len, bundle)) continue;
+
+        auto owner = udpTokens.find(bundle.token);
+        if (owner == udpTokens.end()) continue;
+        auto it = connections.find(owner->second);
+        if (it == connections.end() || it->second.slot < 0) continue;
+        Connection &conn = it->second;
+
+        for (int i = bundle.count - 1; i >= 0; --i) {
+            const InputProtocol::Frame &frame = bundle.frames[i];
+            if (conn.haveUdpSeq && !InputProtocol::isNewer(frame.seq, conn.udpLastSeq)) {
+                ++staleDatagramFrames;
+                continue;
+            }
+            conn.haveUdpSeq = true;
+            conn.udpLastSeq = frame.seq;
+            applyInput(conn.slot, frame.direction, frame.rotation, frame.fire);
+        }
     }
-    else if (token.find("BTN:") == 0) {
-        buttonPressed = (token.substr(4) == "1");
+}
+
+// Text fallback: newline-terminated messages, handled as views into readBuf
+bool GameServer::processTextMessages(Connection &conn, size_t &consumed) {
+    std::string_view pending(conn.readBuf);
+
+    size_t end = pending.find('\n');
+    while (end != std::string_view::npos) {
+        processMessage(conn, pending.substr(consumed, end - consumed));
+        consumed = end + 1;
+        end = pending.find('\n', consumed);
     }
-    else if (token == "CHEAT") {
-        if (gameState) {
-            gameState->restoreTankHealth();
+    return true;
+}
+
+// One message is the full input state, e.g. "UP,ROT:2,BTN:1"
+void GameServer::processMessage(Connection &conn, std::string_view message) {
+    Direction direction = Direction::NONE;
+    int rotation = 0;
+    bool fire = false;
+
+    while (!message.empty()) {
+        size_t comma = message.find(',');
+        std::string_view token = message.substr(0, comma);
+        message = comma == std::string_view::npos ? std::string_view() : message.substr(comma + 1);
+
+        if (token == "UP") direction = Direction::UP;
+        else if (token == "DOWN") direction = Direction::DOWN;
+        else if (token == "LEFT") direction = Direction::LEFT;
+        else if (token == "RIGHT") direction = Direction::RIGHT;
+        else if (token.substr(0, 4) == "ROT:") {
+            int value = 0;
+            auto parsed = std::from_chars(token.data() + 4, token.data() + token.size(), value);
+            // Ignore a malformed rotation
+            if (parsed.ec == std::errc()) rotation += value;
+        }
+        else if (token == "BTN:1") fire = true;
+        else if (token == "CHEAT") {
+            requestCheat(conn);
+            return;
+        }
+        else if (token == "STATE") {
+            subscribe(conn);
+            return;
         }
+    }
 
+    if (conn.slot >= 0) {
+        applyInput(conn.slot, direction, rotation, fire);
     }
 }
 
+// Every input message becomes one event; the simulation decides its tick
+void GameServer::applyInput(int slot, Direction direction, int rotation, bool fire) {
+    inputs[slot].push({std::chrono::steady_clock::now(), direction, rotation, fire, false});
+}
 
-// Sends the tank's current health to the client
-void GameServer::sendTankHealth(int health) const {
-    if (client_fd > 0) {
-        char buffer[16];
-        snprintf(buffer, sizeof(buffer), "HP:%d\n", health);
+// Cheats go through the input ring too, so they land on a tick like any
+// other input and a recorded session replays them
+void GameServer::requestCheat(Connection &conn) {
+    if (conn.slot >= 0) {
+        inputs[conn.slot].push({std::chrono::steady_clock::now(), Direction::NONE, 0, false, true});
+    }
+}
 
-        if (send(client_fd, buffer, strlen(buffer), 0) == -1) {
-            perror("Failed to send tank health");
+// Move this tick's batch into the outbound queue and write as much of the
+// queue as the socket takes, in one gather send. Returns false if the
+// connection should be closed.
+bool GameServer::flushClient(Connection &conn) {
+    TRACE_ZONE("GameServer::flushClient");
+    Telemetry::ScopedTimer timer(Telemetry::netFlush);
+    {
+        auto lock = lockTimed(writeMutex, Telemetry::netLockWait);
+        if (conn.overflowed) return false;
+        if (!conn.pending.empty()) {
+            conn.outQueue.push_back(std::move(conn.pending));
+            conn.pending = std::move(conn.spare);
+            conn.pending.clear();
         }
     }
-}
 
-// Sends a game over message to the client
-void GameServer::sendGameOver(const char* message) const {
-    if (client_fd > 0) {
-        if (send(client_fd, message, strlen(message), 0) == -1) {
-            perror("Failed to send game over message");
+    size_t sentTotal = 0;
+    while (!conn.outQueue.empty()) {
+        iovec iov[MAX_IOVECS];
+        int count = 0;
+        size_t requested = 0;
+        for (auto it = conn.outQueue.begin(); it != conn.outQueue.end() && count < MAX_IOVECS; ++it, ++count) {
+            size_t offset = count == 0 ? conn.outOffset : 0;
+            iov[count].iov_base = const_cast<char *>(it->data() + offset);
+            iov[count].iov_len = it->size() - offset;
+            requested += iov[count].iov_len;
+        }
+
+        // sendmsg rather than writev so a closed peer is not a SIGPIPE
+        msghdr msg{};
+        msg.msg_iov = iov;
+        msg.msg_iovlen = count;
+        ssize_t n = sendmsg(conn.fd, &msg, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            return false;
+        }
+
+        sentTotal += n;
+        size_t left = n;
+        while (left > 0) {
+            size_t rest = conn.outQueue.front().size() - conn.outOffset;
+            if (left < rest) {
+                conn.outOffset += left;
+                break;
+            }
+            left -= rest;
+            conn.outOffset = 0;
+            // Keep one buffer around so steady-state batches reuse its capacity
+            if (conn.spare.capacity() == 0) {
+                conn.spare = std::move(conn.outQueue.front());
+            }
+            conn.outQueue.pop_front();
         }
+        // Socket buffer is full; EPOLLOUT resumes from here
+        if (static_cast<size_t>(n) < requested) break;
+    }
+
+    if (sentTotal > 0) {
+        Telemetry::bytesOut.add(sentTotal);
+        auto lock = lockTimed(writeMutex, Telemetry::netLockWait);
+        conn.queuedBytes -= sentTotal;
     }
+    updateWriteInterest(conn);
+    return true;
 }
 
-// Sends a hit notification to the client
-void GameServer::sendHitMessage() const {
-    if (client_fd > 0) {
-        const char* message = "HIT\n";
-        if (send(client_fd, message, strlen(message), 0) == -1) {
-            perror("Failed to send hit message");
+void GameServer::flushAll() {
+    closing.clear();
+    for (auto &entry: connections) {
+        if (!flushClient(entry.second)) {
+            closing.push_back(entry.first);
         }
     }
+    for (int fd: closing) {
+        if (connections.at(fd).overflowed) {
+            std::cerr << "Client is not reading; disconnecting" << std::endl;
+            ++slowClientsClosed;
+        }
+        closeClient(fd);
+    }
 }
 
-// Gracefully shuts down and closes both server and client sockets
-void GameServer::stop() {
-    if (client_fd > 0) {
-        shutdown(client_fd, SHUT_RDWR);
-        close(client_fd);
-        client_fd = -1;
+// Only ask for EPOLLOUT while there is output the socket would not take
+void GameServer::updateWriteInterest(Connection &conn) {
+    bool want = !conn.outQueue.empty();
+    if (want == conn.wantWrite) return;
+
+    epoll_event ev{};
+    ev.events = EPOLLIN | (want ? static_cast<uint32_t>(EPOLLOUT) : 0u);
+    ev.data.fd = conn.fd;
+    epoll_ctl(epoll_fd, EPOLL_CTL_MOD, conn.fd, &ev);
+    conn.wantWrite = want;
+}
+
+void GameServer::closeClient(int fd) {
+    auto it = connections.find(fd);
+    if (it == connections.end()) return;
+
+    if (it->second.udpToken != 0) {
+        udpTokens.erase(it->second.udpToken);
+    }
+    if (it->second.subscribed) {
+        --stateSubscribers;
+    }
+
+    int slot = it->second.slot;
+    if (slot >= 0) {
+        slotOwner[slot] = -1;
+        // Stop the tank once the simulation gets here
+        applyInput(slot, Direction::NONE, 0, false);
+    }
+
+    epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+    shutdown(fd, SHUT_RDWR);
+    close(fd);
+
+    {
+        std::lock_guard<std::mutex> lock(writeMutex);
+        connections.erase(it);
+    }
+    --clientCount;
+}
+
+// Gracefully close every client and the listening socket
+void GameServer::closeAll() {
+    while (!connections.empty()) {
+        closeClient(connections.begin()->first);
     }
     if (server_fd > 0) {
+        epoll_ctl(epoll_fd, EPOLL_CTL_DEL, server_fd, nullptr);
         shutdown(server_fd, SHUT_RDWR);
         close(server_fd);
         server_fd = -1;
     }
-    std::cout << "Server stopped" << std::endl;
+    if (udp_fd > 0) {
+        epoll_ctl(epoll_fd, EPOLL_CTL_DEL, udp_fd, nullptr);
+        close(udp_fd);
+        udp_fd = -1;
+    }
+}
+
+TickInput GameServer::sampleInput(int slot, std::chrono::steady_clock::time_point deadline) {
+    TickInput input;
+    if (slot < 0 || slot >= MAX_PLAYER_SLOTS) return input;
+
+    InputRing &ring = inputs[slot];
+    auto now = std::chrono::steady_clock::now();
+    while (const InputEvent *event = ring.peek()) {
+        if (event->receivedAt > deadline) break;
+        if (event->fire && input.fire) break;   // second shot belongs to the next tick
+
+        if (event->cheat) {
+            input.restoreHealth = true;
+        } else {
+            heldDirection[slot] = event->direction;
+        }
+        input.rotationDelta += event->rotation;
+        input.fire = input.fire || event->fire;
+        Telemetry::inputLatency.record(static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(now - event->receivedAt).count()));
+        ring.pop();
+    }
+
+    input.direction = heldDirection[slot];
+    return input;
+}
+
+// Queue a message for every connection; flush() hands it to the network thread
+void GameServer::broadcast(const char *message, size_t len) {
+    auto lock = lockTimed(writeMutex, Telemetry::simLockWait);
+    queueForAll(message, len);
+}
+
+// Caller holds writeMutex
+void GameServer::queueForAll(const char *message, size_t len) {
+    for (auto &entry: connections) {
+        Connection &conn = entry.second;
+        if (conn.overflowed) continue;
+        // Events must not be dropped, so a client this far behind is closed
+        if (conn.queuedBytes + len > HARD_WRITE_LIMIT) {
+            conn.overflowed = true;
+            continue;
+        }
+        conn.pending.append(message, len);
+        conn.queuedBytes += len;
+    }
+}
+
+void GameServer::flush() {
+    if (clientCount > 0) {
+        wakeNetworkThread();
+    }
+}
+
+// Start streaming state to this client from the next keyframe
+void GameServer::subscribe(Connection &conn) {
+    if (conn.subscribed) return;
+    {
+        std::lock_guard<std::mutex> lock(writeMutex);
+        conn.subscribed = true;
+        conn.needsKeyframe = true;
+    }
+    ++stateSubscribers;
+    keyframeRequested = true;
+}
+
+void GameServer::sendState(const std::string &frame, bool isKeyframe) {
+    Telemetry::stateBytes.add(frame.size());
+    auto lock = lockTimed(writeMutex, Telemetry::simLockWait);
+    for (auto &entry: connections) {
+        Connection &conn = entry.second;
+        if (!conn.subscribed || conn.overflowed) continue;
+        if (conn.needsKeyframe && !isKeyframe) continue;
+
+        // A dropped delta would corrupt the client's copy, so resync instead
+        if (conn.queuedBytes + frame.size() > SOFT_WRITE_LIMIT) {
+            conn.needsKeyframe = true;
+            keyframeRequested = true;
+            ++droppedStateFrames;
+            continue;
+        }
+        conn.pending += frame;
+        conn.queuedBytes += frame.size();
+        conn.needsKeyframe = false;
+    }
+}
+
+// Sends the tank's current health to the clients when it changed
+void GameServer::sendTankHealth(int health) {
+    auto lock = lockTimed(writeMutex, Telemetry::simLockWait);
+    if (lastHealth == health) return;
+    lastHealth = health;
+
+    char buffer[16];
+    int len = snprintf(buffer, sizeof(buffer), "HP:%d\n", health);
+    queueForAll(buffer, len);
+}
+
+// Sends a game over message to the clients
+void GameServer::sendGameOver(const char* message) {
+    broadcast(message, strlen(message));
+}
+
+// Sends a hit notification to the clients
+void GameServer::sendHitMessage() {
+    const char* message = "HIT\n";
+    broadcast(message, strlen(message));
 }
 
 // Registers a cleanup handler with the shutdown module
@@ -192,7 +698,3 @@ void GameServer::registerServerCleanup() {
         this->stop();
     });
 }
-
-void GameServer::setGameState(GameState* gs) {
-    gameState = gs;
-}
\ No newline at end of file
@@ -1,53 +1,87 @@
 #include "../include/GameState.h"
 #include "GameServer.h"
+#include "Trace.h"
 #include <algorithm>
 #include <cmath>
-#include <ctime>
-#include <mutex>
+#include <cstring>
 
-GameState::GameState()
-        : tank{512, 384, 10, 3},
+GameState::GameState(std::uint32_t seed)
+        : tank{512.0f, 384.0f, TANK_SPEED, 3},
+          tankPrevX(tank.x),
+          tankPrevY(tank.y),
+          tankDirection(Direction::RIGHT),
           turretAngle(90.0f),
-          rng(std::time(nullptr)),
+          projectileGrid(1024.0f, 768.0f, GRID_CELL_SIZE),
+          projectileGridDirty(true),
+          rng(seed),
           xDist(100.0f, 924.0f),
           yDist(100.0f, 668.0f),
           enemyShootTimer(0.0f),
           tankHitEffectTimer(0.0f),
+          lastTickSeconds(1.0f / 60.0f),
           playerAlive(true),
           currentWave(0),
           enemiesKilledThisWave(0) {
     spawnEnemies();
 }
 
-void GameState::updateTankPosition(Direction dir) {
-    std::lock_guard<std::recursive_mutex> lock(mtx);
+// Run one fixed-length simulation tick
+void GameState::step(const TickInput &input, float dt) {
+    TRACE_ZONE("GameState::step");
+    tankPrevX = tank.x;
+    tankPrevY = tank.y;
+    lastTickSeconds = dt;
+
+    if (input.restoreHealth) {
+        restoreTankHealth();
+    }
+    if (input.direction != Direction::NONE) {
+        updateTankPosition(input.direction, dt);
+    }
+    if (input.rotationDelta != 0) {
+        updateTurretRotation(input.rotationDelta);
+    }
+    if (input.fire) {
+        fireProjectile();
+    }
+
+    updateEnemies(dt);
+    updateEnemyFire();
+    updateProjectiles(dt);
+}
+
+void GameState::updateTankPosition(Direction dir, float dt) {
     if (!playerAlive) return;
 
+    if (dir != Direction::NONE) {
+        tankDirection = dir;
+    }
+
+    float distance = tank.speed * dt;
     switch (dir) {
         case Direction::UP:
-            tank.y -= tank.speed;
+            tank.y -= distance;
             break;
         case Direction::DOWN:
-            tank.y += tank.speed;
+            tank.y += distance;
             break;
         case Direction::LEFT:
-            tank.x -= tank.speed;
+            tank.x -= distance;
             break;
         case Direction::RIGHT:
-            tank.x += tank.speed;
+            tank.x += distance;
             break;
         default:
             break;
     }
 
     // Keep tank within screen bounds
-    tank.x = std::max(0, std::min(tank.x, 1024));
-    tank.y = std::max(0, std::min(tank.y, 768));
+    tank.x = std::max(0.0f, std::min(tank.x, 1024.0f));
+    tank.y = std::max(0.0f, std::min(tank.y, 768.0f));
 }
 
 // Rotate turret by a delta (positive or negative)
 void GameState::updateTurretRotation(int delta) {
-    std::lock_guard<std::recursive_mutex> lock(mtx);
     if (!playerAlive) return;
 
     turretAngle += delta * 10.0f;
@@ -57,52 +91,64 @@ void GameState::updateTurretRotation(int delta) {
 
 // Create a new projectile from the tank
 void GameState::fireProjectile() {
-    std::lock_guard<std::recursive_mutex> lock(mtx);
     if (!playerAlive) return;
 
-    Projectile p;
-    p.x = tank.x;
-    p.y = tank.y;
-    p.angle = turretAngle;
-    p.speed = 15.0f;
-    p.isEnemyProjectile = false;
-    projectiles.push_back(p);
+    projectiles.spawn(tank.x, tank.y, turretAngle, PLAYER_PROJECTILE_SPEED, false);
+    projectileGridDirty = true;
 }
 
 // Create a new projectile from an enemy
 void GameState::enemyFireProjectile(float x, float y, float angle) {
-    std::lock_guard<std::recursive_mutex> lock(mtx);
-    Projectile p;
-    p.x = x;
-    p.y = y;
-    p.angle = angle;
-    p.speed = 10.0f;
-    p.isEnemyProjectile = true;
-    projectiles.push_back(p);
+    projectiles.spawn(x, y, angle, ENEMY_PROJECTILE_SPEED, true);
+    projectileGridDirty = true;
 }
 
-// Move all projectiles and handle off-screen cleanup + collision
-void GameState::updateProjectiles() {
-    std::lock_guard<std::recursive_mutex> lock(mtx);
-    const float pi = 3.14159265f;
+// Advance enemy spawn and shoot timers
+void GameState::updateEnemies(float dt) {
+    for (auto &enemy: enemies) {
+        enemy.update(dt);
+    }
+}
 
-    // Decrease hit effect timer
-    if (tankHitEffectTimer > 0) {
-        tankHitEffectTimer -= 1.0f / 60.0f; // Assuming 60 FPS
+// Enemies whose cooldown has elapsed fire straight ahead
+void GameState::updateEnemyFire() {
+    for (auto &enemy: enemies) {
+        if (enemy.canShoot() && enemy.isActive()) {
+            float angle;
+            switch (enemy.getDirection()) {
+                case Direction::UP:
+                    angle = 0.0f;
+                    break;
+                case Direction::RIGHT:
+                    angle = 90.0f;
+                    break;
+                case Direction::DOWN:
+                    angle = 180.0f;
+                    break;
+                case Direction::LEFT:
+                    angle = 270.0f;
+                    break;
+                default:
+                    angle = 0.0f;
+                    break;
+            }
+            enemyFireProjectile(enemy.getPosition().x, enemy.getPosition().y, angle);
+            enemy.resetShootTimer();
+        }
     }
+}
 
-    for (auto& p : projectiles) {
-        float radians = (p.angle - 90) * pi / 180.0f;
-        p.x += p.speed * cos(radians);
-        p.y += p.speed * sin(radians);
+// Move all projectiles and handle off-screen cleanup + collision
+void GameState::updateProjectiles(float dt) {
+    TRACE_ZONE("GameState::updateProjectiles");
+    // Decrease hit effect timer
+    if (tankHitEffectTimer > 0) {
+        tankHitEffectTimer -= dt;
     }
 
-    projectiles.erase(
-            std::remove_if(projectiles.begin(), projectiles.end(),
-                           [](const Projectile &p) {
-                               return p.x < 0 || p.x > 1024 || p.y < 0 || p.y > 768;
-                           }),
-            projectiles.end());
+    // Move and cull off-screen projectiles in one vectorized pass
+    projectiles.integrate(dt, 1024.0f, 768.0f);
+    projectileGridDirty = true;
 
     checkProjectileCollisions();
     checkTankHit();
@@ -110,11 +156,11 @@ void GameState::updateProjectiles() {
 
 // Spawn a new wave of enemies if all are cleared
 void GameState::spawnEnemies() {
-    std::lock_guard<std::recursive_mutex> lock(mtx);
+    TRACE_ZONE("GameState::spawnEnemies");
     // Only spawn new enemies if all current ones are dead
     bool allDead = std::all_of(enemies.begin(), enemies.end(),
-                               [](const std::unique_ptr<Enemy>& e) {
-                                   return !e->isActive() && !e->isSpawning();
+                               [](const Enemy &e) {
+                                   return !e.isActive() && !e.isSpawning();
                                });
 
     if (allDead || enemies.empty()) {
@@ -126,55 +172,81 @@ void GameState::spawnEnemies() {
         std::uniform_int_distribution<int> countDist(minEnemies, maxEnemies);
         int enemyCount = countDist(rng);
 
-        // Spawn new enemies at random positions
+        // Spawn new enemies at random positions, facing a random direction
+        std::uniform_int_distribution<int> dirDist(1, 4);
         for (int i = 0; i < enemyCount; i++) {
             float x = xDist(rng);
             float y = yDist(rng);
-            enemies.push_back(std::make_unique<Enemy>(x, y));
+            auto dir = static_cast<Direction>(dirDist(rng));
+            enemies.spawn(x, y, dir, nextEnemyId++);
         }
 
         enemiesKilledThisWave = 0;
     }
 }
 
+void GameState::startWave(int wave) {
+    enemies.clear();
+    currentWave = std::max(0, wave);
+    spawnEnemies();
+}
+
+// Bucket all projectiles into the broadphase grid if they changed
+void GameState::rebuildProjectileGrid() {
+    if (!projectileGridDirty) return;
+
+    projectileGrid.clear();
+    for (int i = 0; i < projectiles.size(); ++i) {
+        projectileGrid.insert(i, projectiles.x(i), projectiles.y(i));
+    }
+    projectileGrid.build();
+
+    projectileHit.assign(projectiles.size(), 0);
+    projectileGridDirty = false;
+}
+
+// Swap-and-pop projectiles flagged by the collision passes. Walking from the
+// back keeps the flags of not-yet-visited indices valid.
+void GameState::removeHitProjectiles() {
+    for (int i = projectiles.size() - 1; i >= 0; --i) {
+        if (projectileHit[i]) {
+            projectiles.remove(i);
+            projectileGridDirty = true;
+        }
+    }
+}
+
 // Handle projectile collision with enemies
 void GameState::checkProjectileCollisions() {
-    std::lock_guard<std::recursive_mutex> lock(mtx);
-    for (auto it = projectiles.begin(); it != projectiles.end();) {
-        bool hit = false;
-
-        // Only player projectiles can hit enemies
-        if (!it->isEnemyProjectile) {
-            for (auto &enemy: enemies) {
-                if (enemy->isActive()) {
-                    float dx = it->x - enemy->getPosition().x;
-                    float dy = it->y - enemy->getPosition().y;
-                    float distance = std::sqrt(dx * dx + dy * dy);
-                    if (distance < enemy->getRadius()) {
-                        enemy->hit();
-                        hit = true;
-                        enemiesKilledThisWave++;
-                        break;
-                    }
-                }
+    TRACE_ZONE("GameState::checkProjectileCollisions");
+    rebuildProjectileGrid();
+
+    // Each active enemy is destroyed by the earliest player projectile overlapping it
+    for (auto &enemy: enemies) {
+        if (!enemy.isActive()) continue;
+
+        int firstHit = -1;
+        Vec2 pos = enemy.getPosition();
+        projectileGrid.query(pos.x, pos.y, Enemy::getRadius(), [&](int id) {
+            if (!projectiles.isEnemy(id) && !projectileHit[id] &&
+                (firstHit < 0 || id < firstHit)) {
+                firstHit = id;
             }
-        }
+        });
 
-        // Remove projectile if it hit
-        if (hit) {
-            it = projectiles.erase(it);
-        } else {
-            ++it;
+        if (firstHit >= 0) {
+            projectileHit[firstHit] = 1;
+            enemy.hit();
+            enemiesKilledThisWave++;
         }
     }
 
+    removeHitProjectiles();
+
     // Remove dead enemies
-    enemies.erase(
-            std::remove_if(enemies.begin(), enemies.end(),
-                           [](const std::unique_ptr<Enemy> &e) {
-                               return !e->isActive() && !e->isSpawning();
-                           }),
-            enemies.end());
+    enemies.removeIf([](const Enemy &e) {
+        return !e.isActive() && !e.isSpawning();
+    });
 
     // Check if we should spawn new enemies
     if (enemies.empty()) {
@@ -185,38 +257,35 @@ void GameState::checkProjectileCollisions() {
 
 // Check if tank was hit by enemy projectiles
 void GameState::checkTankHit() {
-    std::lock_guard<std::recursive_mutex> lock(mtx);
     if (!playerAlive) return;
 
-    for (auto it = projectiles.begin(); it != projectiles.end();) {
+    rebuildProjectileGrid();
 
-        // Player tank hit detection
-        if (it->isEnemyProjectile) {
-            float dx = it->x - tank.x;
-            float dy = it->y - tank.y;
-            float distance = std::sqrt(dx * dx + dy * dy);
-            if (distance < 20.0f) {
-                tank.health--;
-                tankHitEffectTimer = HIT_EFFECT_DURATION;
-                it = projectiles.erase(it);
+    int hits = 0;
+    projectileGrid.query(tank.x, tank.y, TANK_HIT_RADIUS, [&](int id) {
+        if (projectiles.isEnemy(id) && !projectileHit[id]) {
+            projectileHit[id] = 1;
+            hits++;
+        }
+    });
 
-                if (tank.health <= 0) {
-                    playerAlive = false;
-                }
+    for (int i = 0; i < hits; ++i) {
+        tank.health--;
+        tankHitEffectTimer = HIT_EFFECT_DURATION;
 
-                if (server) {
-                    server->sendHitMessage();
-                }
+        if (tank.health <= 0) {
+            playerAlive = false;
+        }
 
-                continue;
-            }
+        if (server) {
+            server->sendHitMessage();
         }
-        ++it;
     }
+
+    removeHitProjectiles();
 }
 
 void GameState::restoreTankHealth() {
-    std::lock_guard<std::recursive_mutex> lock(mtx);
     if (!playerAlive) return;
 
     tank.health = 3;
@@ -231,14 +300,92 @@ const Tank &GameState::getTank() const { return tank; }
 
 float GameState::getTurretAngle() const { return turretAngle; }
 
-const std::vector<Projectile> &GameState::getProjectiles() const { return projectiles; }
+const ProjectilePool &GameState::getProjectiles() const { return projectiles; }
 
-const std::vector<std::unique_ptr<Enemy>> &GameState::getEnemies() const { return enemies; }
+const EnemyPool &GameState::getEnemies() const { return enemies; }
 
 bool GameState::isPlayerAlive() const { return playerAlive; }
 
 float GameState::getTankHitEffect() const { return tankHitEffectTimer; }
 
+Direction GameState::getTankDirection() const { return tankDirection; }
+
+void GameState::writeSnapshot(FrameSnapshot &out) const {
+    out.tank = tank;
+    out.tankPrevX = tankPrevX;
+    out.tankPrevY = tankPrevY;
+    out.tankDirection = tankDirection;
+    out.turretAngle = turretAngle;
+    out.tankHitEffect = tankHitEffectTimer;
+    out.playerAlive = playerAlive;
+    out.wave = currentWave;
+
+    out.projectiles.clear();
+    for (int i = 0; i < projectiles.size(); ++i) {
+        float x = projectiles.x(i);
+        float y = projectiles.y(i);
+        out.projectiles.push_back({x, y,
+                                   x - projectiles.velocityX(i) * lastTickSeconds,
+                                   y - projectiles.velocityY(i) * lastTickSeconds,
+                                   projectiles.isEnemy(i), projectiles.id(i)});
+    }
+
+    out.enemies.clear();
+    for (const auto &enemy: enemies) {
+        Vec2 pos = enemy.getPosition();
+        out.enemies.push_back({pos.x, pos.y, enemy.getDirection(), enemy.isSpawning(), enemy.isActive(),
+                               enemy.getId()});
+    }
+}
+
+namespace {
+
+// FNV-1a over raw bytes; floats are hashed bit for bit
+struct Fnv1a {
+    std::uint64_t hash = 14695981039346656037ull;
+
+    template<typename T>
+    void add(const T &value) {
+        unsigned char bytes[sizeof(T)];
+        std::memcpy(bytes, &value, sizeof(T));
+        for (unsigned char b: bytes) {
+            hash = (hash ^ b) * 1099511628211ull;
+        }
+    }
+};
+
+} // namespace
+
+std::uint64_t GameState::checksum() const {
+    Fnv1a h;
+    h.add(tank.x);
+    h.add(tank.y);
+    h.add(tank.health);
+    h.add(turretAngle);
+    h.add(playerAlive);
+    h.add(currentWave);
+    h.add(enemiesKilledThisWave);
+    h.add(enemyShootTimer);
+
+    h.add(projectiles.size());
+    for (int i = 0; i < projectiles.size(); ++i) {
+        h.add(projectiles.id(i));
+        h.add(projectiles.x(i));
+        h.add(projectiles.y(i));
+    }
+
+    h.add(static_cast<std::size_t>(enemies.size()));
+    for (const auto &enemy: enemies) {
+        Vec2 pos = enemy.getPosition();
+        h.add(enemy.getId());
+        h.add(pos.x);
+        h.add(pos.y);
+        h.add(enemy.isActive());
+        h.add(enemy.isSpawning());
+    }
+    return h.hash;
+}
+
 // Link to server to allow outbound messages (e.g., tank hit)
 void GameState::setServer(GameServer *srv) {
     server = srv;
@@ -0,0 +1,78 @@
+#include "../include/InputProtocol.h"
+
+namespace InputProtocol {
+
+    static std::uint16_t readU16(const unsigned char* p) {
+        return static_cast<std::uint16_t>((p[0] << 8) | p[1]);
+    }
+
+    static void readInput(const unsigned char* payload, Frame& out) {
+        std::uint8_t dir = payload[2];
+        out.type = FrameType::INPUT;
+        out.seq = readU16(payload);
+        out.direction = dir <= static_cast<std::uint8_t>(Direction::RIGHT)
+                        ? static_cast<Direction>(dir) : Direction::NONE;
+        out.rotation = static_cast<std::int16_t>(readU16(payload + 3));
+        out.fire = (payload[5] & FLAG_FIRE) != 0;
+    }
+
+    ParseResult parse(const char* data, std::size_t len, Frame& out, std::size_t& consumed) {
+        const auto* p = reinterpret_cast<const unsigned char*>(data);
+        if (len < HEADER_SIZE) {
+            // Reject a bad magic byte as early as possible
+            return (len > 0 && p[0] != MAGIC) ? ParseResult::INVALID : ParseResult::NEED_MORE;
+        }
+        if (p[0] != MAGIC || p[1] != VERSION) {
+            return ParseResult::INVALID;
+        }
+
+        std::size_t payloadLen = p[3];
+        if (len < HEADER_SIZE + payloadLen) {
+            return ParseResult::NEED_MORE;
+        }
+        consumed = HEADER_SIZE + payloadLen;
+
+        const unsigned char* payload = p + HEADER_SIZE;
+        switch (static_cast<FrameType>(p[2])) {
+            case FrameType::INPUT: {
+                if (payloadLen < 6) return ParseResult::INVALID;
+                readInput(payload, out);
+                return ParseResult::FRAME;
+            }
+            case FrameType::CHEAT:
+            case FrameType::SUBSCRIBE:
+                if (payloadLen < 2) return ParseResult::INVALID;
+                out.type = static_cast<FrameType>(p[2]);
+                out.seq = readU16(payload);
+                out.direction = Direction::NONE;
+                out.rotation = 0;
+                out.fire = false;
+                return ParseResult::FRAME;
+            default:
+                return ParseResult::SKIPPED;
+        }
+    }
+
+    bool parseBundle(const char* data, std::size_t len, Bundle& out) {
+        const auto* p = reinterpret_cast<const unsigned char*>(data);
+        if (len < HEADER_SIZE + 5 || p[0] != MAGIC || p[1] != VERSION ||
+            p[2] != static_cast<std::uint8_t>(FrameType::INPUT_BUNDLE)) {
+            return false;
+        }
+
+        std::size_t payloadLen = p[3];
+        const unsigned char* payload = p + HEADER_SIZE;
+        int count = payload[4];
+        if (len < HEADER_SIZE + payloadLen || payloadLen < 5 + 6u * count) {
+            return false;
+        }
+
+        out.token = (static_cast<std::uint32_t>(readU16(payload)) << 16) | readU16(payload + 2);
+        out.count = count < MAX_BUNDLE_FRAMES ? count : MAX_BUNDLE_FRAMES;
+        for (int i = 0; i < out.count; ++i) {
+            readInput(payload + 5 + 6 * i, out.frames[i]);
+        }
+        return true;
+    }
+
+}
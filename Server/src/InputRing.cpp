@@ -0,0 +1,24 @@
+#include "../include/InputRing.h"
+
+bool InputRing::push(const InputEvent &event) {
+    std::uint32_t h = head.load(std::memory_order_relaxed);
+    if (h - tail.load(std::memory_order_acquire) == CAPACITY) {
+        droppedCount.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    events[h & MASK] = event;
+    head.store(h + 1, std::memory_order_release);
+    return true;
+}
+
+const InputEvent *InputRing::peek() const {
+    std::uint32_t t = tail.load(std::memory_order_relaxed);
+    if (t == head.load(std::memory_order_acquire)) {
+        return nullptr;
+    }
+    return &events[t & MASK];
+}
+
+void InputRing::pop() {
+    tail.store(tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
@@ -0,0 +1,77 @@
+#include "../include/ProjectilePool.h"
+#include <cmath>
+
+namespace {
+
+// Branch-free over whole blocks; padding lanes are computed and ignored.
+// Kept as a free function so the restrict qualifiers reach the vectorizer.
+void integrateKernel(float *__restrict px, float *__restrict py,
+                     const float *__restrict vx, const float *__restrict vy,
+                     std::int32_t *__restrict out, int n, float dt, float width, float height) {
+    constexpr int LANES = ProjectilePool::LANES;
+    for (int base = 0; base < n; base += LANES) {
+        for (int lane = 0; lane < LANES; ++lane) {
+            int i = base + lane;
+            float nx = px[i] + vx[i] * dt;
+            float ny = py[i] + vy[i] * dt;
+            px[i] = nx;
+            py[i] = ny;
+            out[i] = (nx < 0.0f) | (nx > width) | (ny < 0.0f) | (ny > height);
+        }
+    }
+}
+
+} // namespace
+
+void ProjectilePool::spawn(float x, float y, float angle, float speed, bool isEnemy) {
+    // Grow by a whole block so the padded length stays a multiple of LANES
+    if (count == static_cast<int>(posX.size())) {
+        size_t padded = posX.size() + LANES;
+        posX.resize(padded, 0.0f);
+        posY.resize(padded, 0.0f);
+        velX.resize(padded, 0.0f);
+        velY.resize(padded, 0.0f);
+        enemy.resize(padded, 0);
+        ids.resize(padded, 0);
+        outOfBounds.resize(padded, 0);
+    }
+
+    const float pi = 3.14159265f;
+    float radians = (angle - 90) * pi / 180.0f;
+
+    posX[count] = x;
+    posY[count] = y;
+    velX[count] = speed * std::cos(radians);
+    velY[count] = speed * std::sin(radians);
+    enemy[count] = isEnemy ? 1 : 0;
+    ids[count] = nextId++;
+    count++;
+}
+
+void ProjectilePool::remove(int i) {
+    int last = count - 1;
+    posX[i] = posX[last];
+    posY[i] = posY[last];
+    velX[i] = velX[last];
+    velY[i] = velY[last];
+    enemy[i] = enemy[last];
+    ids[i] = ids[last];
+    count--;
+}
+
+void ProjectilePool::clear() {
+    count = 0;
+}
+
+void ProjectilePool::integrate(float dt, float width, float height) {
+    const int n = count;
+    integrateKernel(posX.data(), posY.data(), velX.data(), velY.data(),
+                    outOfBounds.data(), n, dt, width, height);
+
+    // Walk backwards so swapped-in elements have already been tested
+    for (int i = n - 1; i >= 0; --i) {
+        if (outOfBounds[i]) {
+            remove(i);
+        }
+    }
+}
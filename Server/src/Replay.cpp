@@ -0,0 +1,185 @@
+#include "../include/Replay.h"
+#include <cstring>
+
+namespace {
+
+const char FILE_MAGIC[4] = {'T', 'K', 'R', 'P'};
+
+void putBigEndian(std::ofstream &out, std::uint64_t v, int bytes) {
+    char buf[8];
+    for (int i = 0; i < bytes; ++i) {
+        buf[i] = static_cast<char>((v >> (8 * (bytes - 1 - i))) & 0xFF);
+    }
+    out.write(buf, bytes);
+}
+
+bool getBigEndian(std::ifstream &in, std::uint64_t &v, int bytes) {
+    unsigned char buf[8];
+    if (!in.read(reinterpret_cast<char *>(buf), bytes)) return false;
+    v = 0;
+    for (int i = 0; i < bytes; ++i) {
+        v = (v << 8) | buf[i];
+    }
+    return true;
+}
+
+std::uint64_t zigzag(int v) {
+    auto wide = static_cast<std::int64_t>(v);
+    return (static_cast<std::uint64_t>(wide) << 1) ^ static_cast<std::uint64_t>(wide >> 63);
+}
+
+int unzigzag(std::uint64_t v) {
+    return static_cast<int>(static_cast<std::int64_t>(v >> 1) ^ -static_cast<std::int64_t>(v & 1));
+}
+
+} // namespace
+
+namespace Replay {
+
+Writer::~Writer() {
+    // No trailer without a checksum, but keep what was recorded
+    if (out.is_open()) {
+        flushRun();
+    }
+}
+
+bool Writer::open(const std::string &path, std::uint32_t seed, double tickRate) {
+    out.open(path, std::ios::binary | std::ios::trunc);
+    if (!out) return false;
+
+    std::uint64_t rateBits;
+    std::memcpy(&rateBits, &tickRate, sizeof(rateBits));
+
+    out.write(FILE_MAGIC, sizeof(FILE_MAGIC));
+    out.put(static_cast<char>(VERSION));
+    putBigEndian(out, seed, 4);
+    putBigEndian(out, rateBits, 8);
+    return static_cast<bool>(out);
+}
+
+void Writer::record(const TickInput &input) {
+    if (!out.is_open()) return;
+
+    bool idle = input.rotationDelta == 0 && !input.fire && !input.restoreHealth;
+    if (idle && (runLength == 0 || input.direction == runDirection)) {
+        runDirection = input.direction;
+        ++runLength;
+        return;
+    }
+    flushRun();
+    if (idle) {
+        runDirection = input.direction;
+        runLength = 1;
+        return;
+    }
+
+    auto head = static_cast<std::uint8_t>(static_cast<std::uint8_t>(input.direction) & DIRECTION_MASK);
+    if (input.rotationDelta != 0) head |= ROTATION;
+    if (input.fire) head |= FIRE;
+    if (input.restoreHealth) head |= CHEAT;
+    out.put(static_cast<char>(head));
+    if (input.rotationDelta != 0) {
+        putVarint(zigzag(input.rotationDelta));
+    }
+}
+
+void Writer::finish(std::uint64_t ticks, std::uint64_t checksum) {
+    if (!out.is_open()) return;
+
+    flushRun();
+    out.put(static_cast<char>(END));
+    putBigEndian(out, ticks, 8);
+    putBigEndian(out, checksum, 8);
+    out.close();
+}
+
+void Writer::flushRun() {
+    if (runLength == 0) return;
+
+    auto head = static_cast<std::uint8_t>(static_cast<std::uint8_t>(runDirection) & DIRECTION_MASK);
+    if (runLength == 1) {
+        out.put(static_cast<char>(head));
+    } else {
+        out.put(static_cast<char>(head | RUN));
+        putVarint(runLength);
+    }
+    runLength = 0;
+}
+
+void Writer::putVarint(std::uint64_t v) {
+    while (v >= 0x80) {
+        out.put(static_cast<char>((v & 0x7F) | 0x80));
+        v >>= 7;
+    }
+    out.put(static_cast<char>(v));
+}
+
+bool Reader::open(const std::string &path) {
+    in.open(path, std::ios::binary);
+    if (!in) return false;
+
+    char magic[sizeof(FILE_MAGIC)];
+    std::uint64_t version, seed, rateBits;
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, FILE_MAGIC, sizeof(magic)) != 0 ||
+        !getBigEndian(in, version, 1) || version != VERSION ||
+        !getBigEndian(in, seed, 4) || !getBigEndian(in, rateBits, 8)) {
+        in.close();
+        return false;
+    }
+
+    fileSeed = static_cast<std::uint32_t>(seed);
+    std::memcpy(&fileTickRate, &rateBits, sizeof(fileTickRate));
+    return fileTickRate > 0.0;
+}
+
+bool Reader::next(TickInput &input) {
+    input = TickInput{};
+    if (runRemaining > 0) {
+        --runRemaining;
+        input.direction = runDirection;
+        return true;
+    }
+
+    int c = in.get();
+    if (c == std::char_traits<char>::eof()) return false;
+
+    auto head = static_cast<std::uint8_t>(c);
+    if (head & END) {
+        trailer = getBigEndian(in, trailerTicks, 8) && getBigEndian(in, trailerChecksum, 8);
+        return false;
+    }
+
+    int direction = head & DIRECTION_MASK;
+    if (direction > static_cast<int>(Direction::RIGHT)) return false;
+    input.direction = static_cast<Direction>(direction);
+
+    if (head & RUN) {
+        std::uint64_t count;
+        if (!getVarint(count) || count == 0) return false;
+        runDirection = input.direction;
+        runRemaining = count - 1;
+        return true;
+    }
+
+    if (head & ROTATION) {
+        std::uint64_t rotation;
+        if (!getVarint(rotation)) return false;
+        input.rotationDelta = unzigzag(rotation);
+    }
+    input.fire = (head & FIRE) != 0;
+    input.restoreHealth = (head & CHEAT) != 0;
+    return true;
+}
+
+bool Reader::getVarint(std::uint64_t &v) {
+    v = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        int c = in.get();
+        if (c == std::char_traits<char>::eof()) return false;
+        v |= static_cast<std::uint64_t>(c & 0x7F) << shift;
+        if (!(c & 0x80)) return true;
+    }
+    return false;
+}
+
+} // namespace Replay
@@ -0,0 +1,66 @@
+#include "../include/ServerConfig.h"
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+static void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " [options]\n"
+              << "  --port=N          TCP port to listen on (default 8080)\n"
+              << "  --legacy-render   Draw each entity separately instead of batching\n"
+              << "  --tick-rate=HZ    Fixed simulation rate (default 60)\n"
+              << "  --max-catch-up=N  Most ticks run per loop when behind (default 8)\n"
+              << "  --headless        No window; run only the simulation and network\n"
+              << "  --unthrottled     Run ticks back to back, faster than real time\n"
+              << "  --max-ticks=N     Exit after N simulation ticks\n"
+              << "  --seed=N          Simulation seed (default: random)\n"
+              << "  --record=FILE     Record the seed and every tick's input to FILE\n"
+              << "  --replay=FILE     Re-simulate a recording as fast as possible and exit\n"
+              << "  --telemetry=FILE  Dump timing histograms and counters to FILE as JSON\n"
+              << "  --telemetry-interval=SEC  How often to rewrite the telemetry file (default 1)\n"
+              << "  --trace=FILE      Write profiling zones as Chrome trace JSON (TANK_TRACE builds)\n"
+              << "  --help            Show this message" << std::endl;
+}
+
+ServerConfig parseServerConfig(int argc, char* argv[]) {
+    ServerConfig config;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        if (std::strncmp(arg, "--port=", 7) == 0) {
+            config.port = std::atoi(arg + 7);
+        } else if (std::strcmp(arg, "--legacy-render") == 0) {
+            config.batchedRender = false;
+        } else if (std::strncmp(arg, "--tick-rate=", 12) == 0) {
+            config.tickRate = std::atof(arg + 12);
+        } else if (std::strncmp(arg, "--max-catch-up=", 15) == 0) {
+            config.maxCatchUpTicks = std::atoi(arg + 15);
+        } else if (std::strcmp(arg, "--headless") == 0) {
+            config.headless = true;
+        } else if (std::strcmp(arg, "--unthrottled") == 0) {
+            config.unthrottled = true;
+        } else if (std::strncmp(arg, "--max-ticks=", 12) == 0) {
+            config.maxTicks = std::strtoull(arg + 12, nullptr, 10);
+        } else if (std::strncmp(arg, "--seed=", 7) == 0) {
+            config.seed = static_cast<std::uint32_t>(std::strtoul(arg + 7, nullptr, 10));
+        } else if (std::strncmp(arg, "--record=", 9) == 0) {
+            config.recordPath = arg + 9;
+        } else if (std::strncmp(arg, "--replay=", 9) == 0) {
+            config.replayPath = arg + 9;
+        } else if (std::strncmp(arg, "--telemetry=", 12) == 0) {
+            config.telemetryPath = arg + 12;
+        } else if (std::strncmp(arg, "--telemetry-interval=", 21) == 0) {
+            config.telemetryInterval = std::atof(arg + 21);
+        } else if (std::strncmp(arg, "--trace=", 8) == 0) {
+            config.tracePath = arg + 8;
+        } else if (std::strcmp(arg, "--help") == 0) {
+            printUsage(argv[0]);
+            std::exit(EXIT_SUCCESS);
+        } else {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            printUsage(argv[0]);
+            std::exit(EXIT_FAILURE);
+        }
+    }
+
+    return config;
+}
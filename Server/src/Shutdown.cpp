@@ -1,4 +1,4 @@
-#include "shutdown.h"
+#include "../include/Shutdown.h"
 #include <iostream>
 
 std::atomic<bool> ShutdownModule::shutdownRequested{false};
@@ -0,0 +1,23 @@
+#include "../include/SnapshotBuffer.h"
+
+SnapshotBuffer::SnapshotBuffer()
+        : middle(1), writeIndex(0), readIndex(2) {
+}
+
+FrameSnapshot& SnapshotBuffer::beginWrite() {
+    return slots[writeIndex];
+}
+
+void SnapshotBuffer::publish() {
+    // Release our writes; take back whichever slot was in the middle
+    std::uint8_t previous = middle.exchange(writeIndex | FRESH, std::memory_order_acq_rel);
+    writeIndex = previous & INDEX_MASK;
+}
+
+const FrameSnapshot& SnapshotBuffer::acquire() {
+    if (middle.load(std::memory_order_relaxed) & FRESH) {
+        std::uint8_t previous = middle.exchange(readIndex, std::memory_order_acq_rel);
+        readIndex = previous & INDEX_MASK;
+    }
+    return slots[readIndex];
+}
@@ -0,0 +1,57 @@
+#include "../include/SpatialGrid.h"
+#include <cmath>
+
+SpatialGrid::SpatialGrid(float width, float height, float cellSize)
+        : cols(std::max(1, static_cast<int>(std::ceil(width / cellSize)))),
+          rows(std::max(1, static_cast<int>(std::ceil(height / cellSize)))),
+          invCellSize(1.0f / cellSize),
+          cellStart(cols * rows + 1, 0) {
+}
+
+void SpatialGrid::clear() {
+    stagedIds.clear();
+    stagedX.clear();
+    stagedY.clear();
+    stagedCell.clear();
+    sortedIds.clear();
+    sortedX.clear();
+    sortedY.clear();
+    std::fill(cellStart.begin(), cellStart.end(), 0);
+}
+
+void SpatialGrid::insert(int id, float x, float y) {
+    stagedIds.push_back(id);
+    stagedX.push_back(x);
+    stagedY.push_back(y);
+    stagedCell.push_back(cellCoord(y, rows) * cols + cellCoord(x, cols));
+}
+
+void SpatialGrid::build() {
+    const size_t count = stagedIds.size();
+
+    // Count entries per cell, shifted by one so the prefix sum yields start offsets
+    std::fill(cellStart.begin(), cellStart.end(), 0);
+    for (size_t i = 0; i < count; ++i) {
+        cellStart[stagedCell[i] + 1]++;
+    }
+    for (size_t c = 1; c < cellStart.size(); ++c) {
+        cellStart[c] += cellStart[c - 1];
+    }
+
+    // Scatter into cell order using a running cursor per cell
+    sortedIds.resize(count);
+    sortedX.resize(count);
+    sortedY.resize(count);
+    cellCursor.assign(cellStart.begin(), cellStart.end() - 1);
+    for (size_t i = 0; i < count; ++i) {
+        int dst = cellCursor[stagedCell[i]]++;
+        sortedIds[dst] = stagedIds[i];
+        sortedX[dst] = stagedX[i];
+        sortedY[dst] = stagedY[i];
+    }
+
+    stagedIds.clear();
+    stagedX.clear();
+    stagedY.clear();
+    stagedCell.clear();
+}
@@ -0,0 +1,195 @@
+#include "../include/StateStream.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+template<typename View>
+void sortById(std::vector<View> &views) {
+    std::sort(views.begin(), views.end(), [](const View &a, const View &b) { return a.id < b.id; });
+}
+
+std::uint8_t enemyState(const FrameSnapshot::EnemyView &e) {
+    return (e.spawning ? StateStream::ENEMY_SPAWNING : 0) | (e.active ? StateStream::ENEMY_ACTIVE : 0);
+}
+
+// Saturate to the signed 16-bit wire range
+std::int16_t clampI16(float v) {
+    return static_cast<std::int16_t>(std::max(-32768.0f, std::min(32767.0f, std::round(v))));
+}
+
+} // namespace
+
+StateStream::StateStream(int keyframeInterval)
+        : keyframeInterval(keyframeInterval),
+          ticksSinceKeyframe(0) {
+}
+
+void StateStream::putU16(std::uint16_t v) {
+    frame.push_back(static_cast<char>(v >> 8));
+    frame.push_back(static_cast<char>(v & 0xFF));
+}
+
+void StateStream::putU32(std::uint32_t v) {
+    putU16(static_cast<std::uint16_t>(v >> 16));
+    putU16(static_cast<std::uint16_t>(v & 0xFFFF));
+}
+
+// Fill in a count reserved with putU16(0) once it is known
+void StateStream::patchU16(std::size_t at, std::uint32_t v) {
+    frame[at] = static_cast<char>((v >> 8) & 0xFF);
+    frame[at + 1] = static_cast<char>(v & 0xFF);
+}
+
+void StateStream::putPos(float v) {
+    putU16(static_cast<std::uint16_t>(std::max(0.0f, std::min(65535.0f, v * 16.0f))));
+}
+
+const std::string &StateStream::encode(const FrameSnapshot &snap, bool forceKeyframe) {
+    // Reuse last tick's vectors for the new state
+    std::swap(previous, current);
+    current.tick = snap.tick;
+    current.tickSeconds = snap.tickSeconds;
+    current.tank = snap.tank;
+    current.tankDirection = snap.tankDirection;
+    current.turretAngle = snap.turretAngle;
+    current.playerAlive = snap.playerAlive;
+    current.wave = snap.wave;
+    current.projectiles.assign(snap.projectiles.begin(), snap.projectiles.end());
+    current.enemies.assign(snap.enemies.begin(), snap.enemies.end());
+    sortById(current.projectiles);
+    sortById(current.enemies);
+
+    keyframe = forceKeyframe || !havePrevious || ++ticksSinceKeyframe >= keyframeInterval;
+    if (keyframe) ticksSinceKeyframe = 0;
+    havePrevious = true;
+
+    frame.clear();
+    putU8(MAGIC);
+    putU8(VERSION);
+    putU8(keyframe ? KEYFRAME : DELTA);
+    putU32(0);   // length, patched below
+    putU32(static_cast<std::uint32_t>(snap.tick));
+
+    std::uint8_t mask = ALL_FIELDS;
+    if (!keyframe) {
+        mask = 0;
+        if (current.tank.x != previous.tank.x || current.tank.y != previous.tank.y) mask |= TANK_POS;
+        if (current.turretAngle != previous.turretAngle) mask |= TANK_TURRET;
+        if (current.tankDirection != previous.tankDirection) mask |= TANK_DIR;
+        if (current.tank.health != previous.tank.health ||
+            current.playerAlive != previous.playerAlive) mask |= TANK_HEALTH;
+        if (current.wave != previous.wave) mask |= WAVE;
+    }
+    writeTank(mask);
+    writeEnemies(keyframe);
+    writeProjectiles(keyframe);
+
+    auto payload = static_cast<std::uint32_t>(frame.size() - HEADER_SIZE);
+    patchU16(3, payload >> 16);
+    patchU16(5, payload & 0xFFFF);
+    return frame;
+}
+
+void StateStream::writeTank(std::uint8_t mask) {
+    putU8(mask);
+    if (mask & TANK_POS) {
+        putPos(current.tank.x);
+        putPos(current.tank.y);
+    }
+    if (mask & TANK_TURRET) {
+        putU16(static_cast<std::uint16_t>(current.turretAngle * 100.0f));
+    }
+    if (mask & TANK_DIR) {
+        putU8(static_cast<std::uint8_t>(current.tankDirection));
+    }
+    if (mask & TANK_HEALTH) {
+        putU8(static_cast<std::uint8_t>(static_cast<std::int8_t>(current.tank.health)));
+        putU8(current.playerAlive ? 1 : 0);
+    }
+    if (mask & WAVE) {
+        putU16(static_cast<std::uint16_t>(current.wave));
+    }
+}
+
+// Enemies do not move; only arrivals, departures and state changes are sent
+void StateStream::writeEnemies(bool full) {
+    const auto &before = previous.enemies;
+    const auto &after = current.enemies;
+
+    // Removed: in before but not after. Count first, then ids.
+    std::size_t countAt = frame.size();
+    putU16(0);
+    int removed = 0;
+    if (!full) {
+        std::size_t j = 0;
+        for (const auto &old: before) {
+            while (j < after.size() && after[j].id < old.id) ++j;
+            if (j == after.size() || after[j].id != old.id) {
+                putU16(static_cast<std::uint16_t>(old.id));
+                ++removed;
+            }
+        }
+    }
+    patchU16(countAt, removed);
+
+    countAt = frame.size();
+    putU16(0);
+    int upserted = 0;
+    std::size_t i = 0;
+    for (const auto &e: after) {
+        if (!full) {
+            while (i < before.size() && before[i].id < e.id) ++i;
+            if (i < before.size() && before[i].id == e.id &&
+                enemyState(before[i]) == enemyState(e) && before[i].direction == e.direction) {
+                continue;
+            }
+        }
+        putU16(static_cast<std::uint16_t>(e.id));
+        putPos(e.x);
+        putPos(e.y);
+        putU8(static_cast<std::uint8_t>(static_cast<std::uint8_t>(e.direction) | enemyState(e) << 4));
+        ++upserted;
+    }
+    patchU16(countAt, upserted);
+}
+
+void StateStream::writeProjectiles(bool full) {
+    const auto &before = previous.projectiles;
+    const auto &after = current.projectiles;
+    float invDt = current.tickSeconds > 0.0f ? 1.0f / current.tickSeconds : 0.0f;
+
+    std::size_t countAt = frame.size();
+    putU16(0);
+    int removed = 0;
+    if (!full) {
+        std::size_t j = 0;
+        for (const auto &old: before) {
+            while (j < after.size() && after[j].id < old.id) ++j;
+            if (j == after.size() || after[j].id != old.id) {
+                putU16(static_cast<std::uint16_t>(old.id));
+                ++removed;
+            }
+        }
+    }
+    patchU16(countAt, removed);
+
+    countAt = frame.size();
+    putU16(0);
+    int added = 0;
+    std::size_t i = 0;
+    for (const auto &p: after) {
+        if (!full) {
+            while (i < before.size() && before[i].id < p.id) ++i;
+            if (i < before.size() && before[i].id == p.id) continue;
+        }
+        putU16(static_cast<std::uint16_t>(p.id));
+        putPos(p.x);
+        putPos(p.y);
+        putU16(static_cast<std::uint16_t>(clampI16((p.x - p.prevX) * invDt)));
+        putU16(static_cast<std::uint16_t>(clampI16((p.y - p.prevY) * invDt)));
+        putU8(p.isEnemy ? 1 : 0);
+        ++added;
+    }
+    patchU16(countAt, added);
+}
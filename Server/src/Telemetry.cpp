@@ -0,0 +1,181 @@
+#include "../include/Telemetry.h"
+#include <condition_variable>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Telemetry {
+
+namespace {
+
+// Filled during static initialization, read-only afterwards
+std::vector<const Histogram *> &histograms() {
+    static std::vector<const Histogram *> all;
+    return all;
+}
+
+std::vector<const Counter *> &counters() {
+    static std::vector<const Counter *> all;
+    return all;
+}
+
+const auto processStart = std::chrono::steady_clock::now();
+
+std::thread dumpThread;
+std::mutex dumpMutex;
+std::condition_variable dumpWake;
+bool dumpStop = false;
+
+void bump(std::atomic<std::uint64_t> &cell, std::uint64_t n) {
+    cell.store(cell.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+bool dumpTo(const std::string &path) {
+    std::string tmp = path + ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::trunc);
+        if (!out) return false;
+        writeJson(out);
+        out << '\n';
+        if (!out) return false;
+    }
+    return std::rename(tmp.c_str(), path.c_str()) == 0;
+}
+
+} // namespace
+
+Histogram simTick("sim.tick_ns");
+Histogram simLoop("sim.loop_ns");
+Histogram inputLatency("sim.input_latency_ns");
+Histogram simLockWait("sim.lock_wait_ns");
+Counter ticks("sim.ticks");
+Counter catchUpTicks("sim.catch_up_ticks");
+Counter stateBytes("sim.state_bytes");
+
+Histogram renderFrame("render.frame_ns");
+Histogram snapshotAge("render.snapshot_age_ns");
+
+Histogram netRead("net.read_ns");
+Histogram netDatagrams("net.datagrams_ns");
+Histogram netFlush("net.flush_ns");
+Histogram netLockWait("net.lock_wait_ns");
+Counter bytesIn("net.bytes_in");
+Counter bytesOut("net.bytes_out");
+Counter datagramsIn("net.datagrams_in");
+
+Histogram::Histogram(const char *name) : metricName(name) {
+    histograms().push_back(this);
+}
+
+int Histogram::bucketOf(std::uint64_t ns) {
+    if (ns < static_cast<std::uint64_t>(LINEAR)) return static_cast<int>(ns);
+    int msb = 63 - __builtin_clzll(ns);
+    int sub = static_cast<int>((ns >> (msb - SUB_BITS)) & ((1 << SUB_BITS) - 1));
+    return LINEAR + ((msb - SUB_BITS - 1) << SUB_BITS) + sub;
+}
+
+std::uint64_t Histogram::bucketUpperBound(int bucket) {
+    if (bucket < LINEAR) return static_cast<std::uint64_t>(bucket);
+    int msb = ((bucket - LINEAR) >> SUB_BITS) + SUB_BITS + 1;
+    std::uint64_t sub = static_cast<std::uint64_t>((bucket - LINEAR) & ((1 << SUB_BITS) - 1));
+    std::uint64_t width = 1ull << (msb - SUB_BITS);
+    return ((1ull << SUB_BITS) + sub) * width + (width - 1);
+}
+
+void Histogram::record(std::uint64_t ns) {
+    bump(buckets[bucketOf(ns)], 1);
+    bump(count, 1);
+    bump(sum, ns);
+    if (ns > max.load(std::memory_order_relaxed)) {
+        max.store(ns, std::memory_order_relaxed);
+    }
+}
+
+void Histogram::recordSince(std::chrono::steady_clock::time_point start) {
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    record(static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+}
+
+void Histogram::writeJson(std::ostream &out) const {
+    std::uint64_t counts[BUCKETS];
+    std::uint64_t total = 0;
+    for (int i = 0; i < BUCKETS; ++i) {
+        counts[i] = buckets[i].load(std::memory_order_relaxed);
+        total += counts[i];
+    }
+
+    const double quantiles[] = {0.5, 0.9, 0.99, 0.999};
+    const char *labels[] = {"p50", "p90", "p99", "p999"};
+
+    out << "{\"count\":" << count.load(std::memory_order_relaxed)
+        << ",\"sum\":" << sum.load(std::memory_order_relaxed)
+        << ",\"max\":" << max.load(std::memory_order_relaxed);
+
+    // Upper bound of the bucket holding each quantile
+    int bucket = 0;
+    std::uint64_t seen = 0;
+    for (int q = 0; q < 4; ++q) {
+        auto rank = static_cast<std::uint64_t>(quantiles[q] * static_cast<double>(total));
+        while (bucket < BUCKETS - 1 && seen + counts[bucket] <= rank) {
+            seen += counts[bucket++];
+        }
+        out << ",\"" << labels[q] << "\":" << (total > 0 ? bucketUpperBound(bucket) : 0);
+    }
+    out << '}';
+}
+
+Counter::Counter(const char *name) : metricName(name) {
+    counters().push_back(this);
+}
+
+void writeJson(std::ostream &out) {
+    auto uptime = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - processStart).count();
+    out << "{\"uptime_ms\":" << uptime << ",\"counters\":{";
+    const char *sep = "";
+    for (const Counter *c: counters()) {
+        out << sep << '"' << c->name() << "\":" << c->get();
+        sep = ",";
+    }
+    out << "},\"histograms\":{";
+    sep = "";
+    for (const Histogram *h: histograms()) {
+        out << sep << '"' << h->name() << "\":";
+        h->writeJson(out);
+        sep = ",";
+    }
+    out << "}}";
+}
+
+void startDumping(const std::string &path, double intervalSeconds) {
+    if (dumpThread.joinable()) return;
+    auto interval = std::chrono::duration<double>(intervalSeconds > 0.0 ? intervalSeconds : 1.0);
+
+    dumpStop = false;
+    dumpThread = std::thread([path, interval]() {
+        std::unique_lock<std::mutex> lock(dumpMutex);
+        bool warned = false;
+        while (true) {
+            bool stopping = dumpWake.wait_for(lock, interval, [] { return dumpStop; });
+            if (!dumpTo(path) && !warned) {
+                std::fprintf(stderr, "Telemetry: cannot write %s\n", path.c_str());
+                warned = true;
+            }
+            if (stopping) break;
+        }
+    });
+}
+
+void stopDumping() {
+    if (!dumpThread.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(dumpMutex);
+        dumpStop = true;
+    }
+    dumpWake.notify_one();
+    dumpThread.join();
+}
+
+} // namespace Telemetry
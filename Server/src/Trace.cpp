@@ -0,0 +1,151 @@
+#include "../include/Trace.h"
+
+#ifdef TANK_TRACE
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Trace {
+
+namespace {
+
+constexpr int PROCESS_ID = 1;                  // the client traces as pid 2
+constexpr std::uint64_t BUFFER_EVENTS = 1 << 16;   // power of two; per thread
+
+// Fields are atomics so write() may read a slot while its owner overwrites
+// it; such slots are detected and skipped rather than torn.
+struct Event {
+    std::atomic<const char *> name{nullptr};
+    std::atomic<std::uint64_t> startUs{0};
+    std::atomic<std::uint64_t> durationUs{0};
+};
+
+struct EventCopy {
+    const char *name;
+    std::uint64_t startUs;
+    std::uint64_t durationUs;
+};
+
+// One per thread, used as a ring: the newest BUFFER_EVENTS zones are kept.
+// Only the owner writes. begun is bumped before a slot is overwritten and
+// count after it is complete (release), so write() on another thread can
+// tell which slots it read intact.
+struct Buffer {
+    int tid = 0;
+    const char *threadName = nullptr;
+    std::atomic<std::uint64_t> begun{0};
+    std::atomic<std::uint64_t> count{0};
+    std::unique_ptr<Event[]> events{new Event[BUFFER_EVENTS]};
+};
+
+std::mutex registryMutex;
+std::vector<std::unique_ptr<Buffer>> buffers;   // kept until exit
+std::string outputPath;
+
+std::uint64_t nowUs() {
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
+Buffer &threadBuffer() {
+    thread_local Buffer *buffer = nullptr;
+    if (!buffer) {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        buffers.push_back(std::make_unique<Buffer>());
+        buffer = buffers.back().get();
+        buffer->tid = static_cast<int>(buffers.size());
+    }
+    return *buffer;
+}
+
+} // namespace
+
+Zone::Zone(const char *name) : name(name), startUs(nowUs()) {
+}
+
+Zone::~Zone() {
+    Buffer &buffer = threadBuffer();
+    std::uint64_t n = buffer.count.load(std::memory_order_relaxed);
+    buffer.begun.store(n + 1, std::memory_order_relaxed);
+
+    // Release keeps the begun bump ahead of every field a reader can see
+    Event &event = buffer.events[n & (BUFFER_EVENTS - 1)];
+    event.name.store(name, std::memory_order_release);
+    event.startUs.store(startUs, std::memory_order_release);
+    event.durationUs.store(nowUs() - startUs, std::memory_order_release);
+    buffer.count.store(n + 1, std::memory_order_release);
+}
+
+void setThreadName(const char *name) {
+    Buffer &buffer = threadBuffer();
+    std::lock_guard<std::mutex> lock(registryMutex);
+    buffer.threadName = name;
+}
+
+bool open(const std::string &path) {
+    std::FILE *file = std::fopen(path.c_str(), "w");
+    if (!file) return false;
+    std::fclose(file);
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+    outputPath = path;
+    return true;
+}
+
+void write() {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    if (outputPath.empty()) return;
+
+    std::FILE *file = std::fopen(outputPath.c_str(), "w");
+    if (!file) return;
+
+    std::fprintf(file, "{\"traceEvents\":[\n");
+    std::fprintf(file, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":0,"
+                       "\"args\":{\"name\":\"TankBattleServer\"}}", PROCESS_ID);
+
+    std::uint64_t overwritten = 0;
+    for (const auto &buffer: buffers) {
+        if (buffer->threadName) {
+            std::fprintf(file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,"
+                               "\"args\":{\"name\":\"%s\"}}", PROCESS_ID, buffer->tid, buffer->threadName);
+        }
+
+        // Copy the ring oldest first, then drop any slot the owner may have
+        // started overwriting while we copied it
+        std::uint64_t end = buffer->count.load(std::memory_order_acquire);
+        std::uint64_t first = end > BUFFER_EVENTS ? end - BUFFER_EVENTS : 0;
+        std::vector<EventCopy> copies;
+        copies.reserve(static_cast<std::size_t>(end - first));
+        for (std::uint64_t i = first; i < end; ++i) {
+            const Event &e = buffer->events[i & (BUFFER_EVENTS - 1)];
+            copies.push_back({e.name.load(std::memory_order_acquire), e.startUs.load(std::memory_order_acquire),
+                              e.durationUs.load(std::memory_order_acquire)});
+        }
+        std::uint64_t begun = buffer->begun.load(std::memory_order_relaxed);
+        std::uint64_t intact = begun > BUFFER_EVENTS ? begun - BUFFER_EVENTS : 0;
+
+        for (std::uint64_t i = std::max(first, intact); i < end; ++i) {
+            const EventCopy &e = copies[static_cast<std::size_t>(i - first)];
+            std::fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%llu,\"dur\":%llu,\"pid\":%d,\"tid\":%d}",
+                         e.name, static_cast<unsigned long long>(e.startUs),
+                         static_cast<unsigned long long>(e.durationUs), PROCESS_ID, buffer->tid);
+        }
+        overwritten += std::max(first, intact);
+    }
+    std::fprintf(file, "\n]}\n");
+    std::fclose(file);
+
+    if (overwritten > 0) {
+        std::fprintf(stderr, "Trace: kept the newest %llu zones per thread, %llu older ones overwritten\n",
+                     static_cast<unsigned long long>(BUFFER_EVENTS), static_cast<unsigned long long>(overwritten));
+    }
+}
+
+} // namespace Trace
+
+#endif